@@ -0,0 +1,274 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "board.h"
+#include "search.h"
+#include "mcts.h"
+#include "multi.h"
+#include "rules.h"
+#include "pattern.h"
+
+// Benchmarks for the engine. Run with an optional maximum thread count
+// (defaults to the number of online cores):
+//
+//   gcc -O2 -o bench bench.c board.c rules.c pattern.c tt.c search.c mcts.c multi.c -lpthread -lm
+//   ./bench 32
+
+static volatile uint64_t sink;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// A reproducible middlegame: alternate X and O on random cells near the
+// centre, skipping any cell that would end the game
+static void makePosition(Board *b, int size, int plies, unsigned seed) {
+    int lo = size / 2 - 2 < 0 ? 0 : size / 2 - 2;
+    int span = size - 2 * lo;
+    boardInit(b, size);
+    srand(seed);
+    for (int ply = 0; ply < plies; ) {
+        int cell = (lo + rand() % span) * size + lo + rand() % span;
+        int player = ply % 2;
+        if (!boardIsEmpty(b, cell)) continue;
+        boardPlace(b, cell, player);
+        if (boardWinsAt(b, cell, player)) {
+            boardRemove(b, cell, player);
+            continue;
+        }
+        ply++;
+    }
+}
+
+// Time to a fixed depth from a cold table, for 1, 2, 4, ... threads
+static void benchSearchScaling(int size, int depth, int maxThreads) {
+    Board b;
+    double base = 0;
+    makePosition(&b, size, 2, 1012u + size);
+    printf("\n%dx%d, depth %d\n", size, size, depth);
+    printf("  threads    time ms        nodes    knodes/s  speedup  depth  score\n");
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        SearchConfig config = {depth, 64 << 20, 0, threads};
+        SearchResult r;
+        Search s;
+        double start, elapsed;
+        if (!searchInit(&s, &config)) {
+            printf("  couldn't allocate the search table\n");
+            return;
+        }
+        start = nowSeconds();
+        searchBestMove(&s, &b, 0, 1, &r);
+        elapsed = nowSeconds() - start;
+        if (threads == 1) base = elapsed;
+        printf("  %7d %10.1f %12lld %11.0f %8.2f %6d %6d\n", threads, elapsed * 1e3,
+               r.nodes, r.nodes / elapsed / 1e3, base / elapsed, r.depth, r.score);
+        searchFree(&s);
+        if (threads < maxThreads && threads * 2 > maxThreads)
+            threads = maxThreads / 2;   // always finish on maxThreads
+    }
+}
+
+// MCTS playouts per second from a cold tree, for 1, 2, 4, ... threads
+static void benchMctsScaling(int size, int players, int playouts, int maxThreads) {
+    Board b;
+    double base = 0;
+    makePosition(&b, size, 0, 0);
+    printf("\n%dx%d, %d players, %d playouts\n", size, size, players, playouts);
+    printf("  threads    time ms   playouts/s  speedup      nodes\n");
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        MctsConfig config = {playouts, 0, threads, 1 << 20, 0};
+        MctsResult r;
+        Mcts m;
+        if (!mctsInit(&m, &config)) {
+            printf("  couldn't allocate the node pool\n");
+            return;
+        }
+        mctsBestMove(&m, &b, 0, players, &r);
+        if (threads == 1) base = r.seconds;
+        printf("  %7d %10.1f %12.0f %8.2f %10zu\n", threads, r.seconds * 1e3,
+               r.playouts / r.seconds, base / r.seconds, r.nodes);
+        mctsFree(&m);
+        if (threads < maxThreads && threads * 2 > maxThreads)
+            threads = maxThreads / 2;
+    }
+}
+
+// Three-player search from a cold table: how deep each mode gets in the
+// time budget, and at what speed
+static void benchMulti(int size, int timeMs) {
+    static const char *modes[] = {"max^n", "paranoid"};
+    Board b;
+    makePosition(&b, size, 6, 2024u + size);
+    printf("\n%dx%d, 3 players, %d ms\n", size, size, timeMs);
+    printf("  mode        depth        nodes    knodes/s  move\n");
+    for (int mode = MULTI_MAXN; mode <= MULTI_PARANOID; mode++) {
+        MultiConfig config = {mode, 0, 64 << 20, timeMs};
+        MultiResult r;
+        MultiSearch s;
+        double start, elapsed;
+        if (!multiInit(&s, &config)) {
+            printf("  couldn't allocate the search table\n");
+            return;
+        }
+        start = nowSeconds();
+        multiBestMove(&s, &b, 0, 3, &r);
+        elapsed = nowSeconds() - start;
+        printf("  %-10s %6d %12lld %11.0f %5d\n", modes[mode], r.depth, r.nodes,
+               r.nodes / elapsed / 1e3, r.move);
+        multiFree(&s);
+    }
+}
+
+// Cost per position of finding the canonical form: just its hash and
+// symmetry (what the search table does at every node), and the whole
+// transformed board. Positions run from empty to half full.
+static void benchCanonical(int size) {
+    enum { POSITIONS = 256, ROUNDS = 4000 };
+    static Board boards[POSITIONS];
+    Board to;
+    uint64_t sum = 0, hash, rng = 77;
+    double start, hashNs, boardNs;
+    for (int i = 0; i < POSITIONS; i++) {
+        boardInit(&boards[i], size);
+        for (int ply = 0; ply < i % (size * size / 2 + 1); ply++)
+            boardPlace(&boards[i], boards[i].freeCells[rngBelow(&rng, boards[i].freeCount)], ply % 2);
+    }
+
+    start = nowSeconds();
+    for (int r = 0; r < ROUNDS; r++)
+        for (int i = 0; i < POSITIONS; i++) {
+            sum += (uint64_t)boardCanonical(&boards[i], &hash);
+            sum ^= hash;
+        }
+    hashNs = (nowSeconds() - start) * 1e9 / ((double)ROUNDS * POSITIONS);
+
+    start = nowSeconds();
+    for (int r = 0; r < ROUNDS / 20; r++)
+        for (int i = 0; i < POSITIONS; i++) {
+            boardTransform(&boards[i], boardCanonical(&boards[i], NULL), &to);
+            sum += to.hashes[0];
+        }
+    boardNs = (nowSeconds() - start) * 1e9 / ((double)(ROUNDS / 20) * POSITIONS);
+
+    printf("\n%dx%d canonical form, %d positions\n", size, size, POSITIONS);
+    printf("  hash + symmetry %8.1f ns/position\n", hashNs);
+    printf("  whole board     %8.1f ns/position\n", boardNs);
+    sink = sum;
+}
+
+// One rules op over a set of positions, in ns per call
+enum { RULES_HAS_WON, RULES_WINS_AT, RULES_THREATS, RULES_OPS };
+
+static double timeRules(const Rules *r, int op, const Board *boards, const int *last, int count) {
+    enum { ROUNDS = 4000 };
+    uint64_t sum = 0;
+    double start = nowSeconds();
+    for (int round = 0; round < ROUNDS; round++)
+        for (int i = 0; i < count; i++) {
+            switch (op) {
+            case RULES_HAS_WON: sum += (uint64_t)r->hasWon(&boards[i], i & 1); break;
+            case RULES_WINS_AT: sum += (uint64_t)r->winsAt(&boards[i], last[i], i & 1); break;
+            default: sum += (uint64_t)r->threats(&boards[i], i & 1); break;
+            }
+        }
+    sink = sum;
+    return (nowSeconds() - start) * 1e9 / ((double)ROUNDS * count);
+}
+
+// The rules compiled for one size against the generic ones, on positions
+// from a few pieces to nearly full. Both are called through the Rules
+// table, the way the game and the search call them.
+static void benchRules(int size) {
+    enum { POSITIONS = 256 };
+    static const char *names[RULES_OPS] = {"hasWon", "winsAt", "threats"};
+    static Board boards[POSITIONS];
+    int last[POSITIONS];
+    uint64_t rng = 2022 + (uint64_t)size;
+    const Rules *fast = rulesFor(size);
+    for (int i = 0; i < POSITIONS; i++) {
+        int plies = 1 + rngBelow(&rng, size * size - 1);
+        boardInit(&boards[i], size);
+        for (int ply = 0; ply < plies; ply++) {
+            last[i] = boards[i].freeCells[rngBelow(&rng, boards[i].freeCount)];
+            boardPlace(&boards[i], last[i], (i + plies - 1 - ply) & 1);
+        }
+    }
+    printf("  %2dx%-2d", size, size);
+    for (int op = 0; op < RULES_OPS; op++) {
+        double generic = timeRules(&genericRules, op, boards, last, POSITIONS);
+        double special = timeRules(fast, op, boards, last, POSITIONS);
+        printf("  %s %6.1f -> %5.1f ns (%4.1fx)", names[op], generic, special, generic / special);
+    }
+    printf("\n");
+}
+
+// Open-window counting, in positions per second for each implementation
+// this CPU has, on positions from empty to nearly full
+static void benchPatterns(int size, int players) {
+    enum { POSITIONS = 256, ROUNDS = 2000 };
+    static Board boards[POSITIONS];
+    uint64_t rng = 2023 + (uint64_t)size, sum = 0;
+    double base = 0;
+    for (int i = 0; i < POSITIONS; i++) {
+        int plies = rngBelow(&rng, size * size);
+        boardInit(&boards[i], size);
+        for (int ply = 0; ply < plies; ply++)
+            boardPlace(&boards[i], boards[i].freeCells[rngBelow(&rng, boards[i].freeCount)], ply % players);
+    }
+    printf("  %2dx%-2d %d players", size, size, players);
+    for (int impl = 0; impl < PATTERN_IMPLS; impl++) {
+        Patterns p;
+        double start, rate;
+        if (!patternCountWith(impl, &boards[0], players, &p)) continue;
+        start = nowSeconds();
+        for (int r = 0; r < ROUNDS; r++)
+            for (int i = 0; i < POSITIONS; i++) {
+                patternCountWith(impl, &boards[i], players, &p);
+                sum += (uint64_t)p.open[r % players][2];
+            }
+        rate = (double)ROUNDS * POSITIONS / (nowSeconds() - start);
+        if (impl == PATTERN_SCALAR) base = rate;
+        printf("  %s %6.1f M/s (%4.1fx)", patternImplNames[impl], rate / 1e6, rate / base);
+    }
+    printf("\n");
+    sink = sum;
+}
+
+int main(int argc, char *argv[]) {
+    int maxThreads = (argc > 1) ? atoi(argv[1]) : (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (maxThreads < 1) maxThreads = 1;
+
+    printf("Search scaling, 1 to %d threads\n", maxThreads);
+    benchSearchScaling(5, 8, maxThreads);
+    benchSearchScaling(7, 7, maxThreads);
+    benchSearchScaling(10, 6, maxThreads);
+
+    printf("\nMCTS scaling, 1 to %d threads\n", maxThreads);
+    benchMctsScaling(5, 2, 100000, maxThreads);
+    benchMctsScaling(10, 2, 100000, maxThreads);
+    benchMctsScaling(10, 3, 100000, maxThreads);
+
+    printf("\nThree-player search\n");
+    benchMulti(7, 100);
+    benchMulti(10, 100);
+
+    benchCanonical(10);
+
+    printf("\nSpecialized rules, generic -> compiled for the size\n");
+    benchRules(3);
+    benchRules(4);
+    benchRules(5);
+    benchRules(7);
+    benchRules(10);
+
+    printf("\nOpen windows counted, positions/s\n");
+    benchPatterns(7, 2);
+    benchPatterns(7, 3);
+    benchPatterns(10, 2);
+    benchPatterns(10, 3);
+    return 0;
+}
@@ -0,0 +1,232 @@
+#include <stdlib.h>
+#include <string.h>
+#include "board.h"
+
+const char playerSymbols[MAX_PLAYERS] = {'X', 'O', 'Z'};
+uint64_t zobristKeys[MAX_PLAYERS][MAX_CELLS];
+unsigned char symmetryCells[MAX_SIZE + 1][SYMMETRIES][MAX_CELLS];
+const unsigned char symmetryInverse[SYMMETRIES] = {0, 1, 2, 3, 4, 6, 5, 7};
+LineTable lineTables[MAX_SIZE + 1];
+
+// Fixed seed, so every run sees the same keys. Filled in before main so
+// threads never race to initialise them.
+__attribute__((constructor))
+static void zobristInit(void) {
+    uint64_t state = 0x5E1012;
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        for (int cell = 0; cell < MAX_CELLS; cell++)
+            zobristKeys[p][cell] = rngNext(&state);
+
+    for (int size = MIN_SIZE; size <= MAX_SIZE; size++)
+        for (int s = 0; s < SYMMETRIES; s++)
+            for (int cell = 0; cell < size * size; cell++) {
+                int row = cell / size, col = cell % size, t;
+                if (s & 4) { t = row; row = col; col = t; }
+                if (s & 1) row = size - 1 - row;
+                if (s & 2) col = size - 1 - col;
+                symmetryCells[size][s][cell] = (unsigned char)(row * size + col);
+            }
+}
+
+// Every segment of winLength cells in each of the four directions
+__attribute__((constructor))
+static void lineTablesInit(void) {
+    for (int size = MIN_SIZE; size <= MAX_SIZE; size++) {
+        LineTable *t = &lineTables[size];
+        Board b;
+        boardInit(&b, size);
+        const int dirs[4] = {1, b.stride, b.stride + 1, b.stride - 1};
+        for (int d = 0; d < 4; d++)
+            for (int cell = 0; cell < size * size; cell++) {
+                Bits line = 0;
+                int bit = cellBit(&b, cell), k;
+                for (k = 0; k < b.winLength; k++, bit += dirs[d]) {
+                    if (bit >= 128 || !((b.valid >> bit) & 1)) break;
+                    line |= (Bits)1 << bit;
+                }
+                if (k < b.winLength) continue;
+                for (Bits m = line; m; m &= m - 1) {
+                    int c = bitCell(&b, bitsFirst(m));
+                    t->cellLines[c][t->cellCount[c]++] = (unsigned char)t->count;
+                }
+                t->lines[t->count++] = line;
+            }
+    }
+}
+
+// Boards of 4 and up only need 4 in a row
+int boardWinLength(int size) {
+    return (size >= 4) ? 4 : size;
+}
+
+// Map 'X', 'O', 'Z' to 0, 1, 2 (or -1 if it isn't a player symbol)
+int symbolIndex(char symbol) {
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        if (playerSymbols[p] == symbol) return p;
+    return -1;
+}
+
+// Empty board with the valid-cell mask for this size
+void boardInit(Board *b, int size) {
+    uint64_t seed = (uint64_t)size;
+    b->size = size;
+    b->winLength = boardWinLength(size);
+    b->stride = size + 1;
+    b->valid = 0;
+    b->occupied = 0;
+    // Seed the hash with the size so tables shared between games of
+    // different sizes never confuse two positions with the same cells
+    seed = rngNext(&seed);
+    for (int s = 0; s < SYMMETRIES; s++)
+        b->hashes[s] = seed;
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        b->pieces[p] = 0;
+    b->freeCount = size * size;
+    for (int cell = 0; cell < size * size; cell++) {
+        b->valid |= cellMask(b, cell);
+        b->freeCells[cell] = (unsigned char)cell;
+        b->freeIndex[cell] = (unsigned char)cell;
+    }
+    b->liveLines = lineTables[size].count;
+    memset(b->lineCounts, 0, sizeof b->lineCounts);
+}
+
+// A line stays winnable while only one player has pieces on it. Counts
+// never pass 4, so adding 7 to each nibble sets its top bit exactly when
+// that player is on the line.
+static inline int lineLive(unsigned counts) {
+    unsigned present = (counts + 0x777) & 0x888;
+    return (present & (present - 1)) == 0;
+}
+
+// Count a piece on (add 1) or off (add -1) every line through cell
+static inline void countLines(Board *b, int cell, int player, int add) {
+    const LineTable *t = boardLines(b);
+    const int step = add << (4 * player);
+    for (int i = 0; i < t->cellCount[cell]; i++) {
+        uint16_t *counts = &b->lineCounts[t->cellLines[cell][i]];
+        int wasLive = lineLive(*counts);
+        *counts = (uint16_t)(*counts + step);
+        b->liveLines += lineLive(*counts) - wasLive;
+    }
+}
+
+// Put a piece on an empty cell. The last free cell is swapped into the
+// slot it leaves so the free list stays packed.
+void boardPlaceUnhashed(Board *b, int cell, int player) {
+    Bits m = cellMask(b, cell);
+    b->pieces[player] |= m;
+    b->occupied |= m;
+    countLines(b, cell, player, 1);
+
+    int slot = b->freeIndex[cell];
+    int last = b->freeCells[--b->freeCount];
+    b->freeCells[slot] = (unsigned char)last;
+    b->freeIndex[last] = (unsigned char)slot;
+}
+
+void boardPlace(Board *b, int cell, int player) {
+    boardPlaceUnhashed(b, cell, player);
+    for (int s = 0; s < SYMMETRIES; s++)
+        b->hashes[s] ^= zobristKeys[player][symmetryCells[b->size][s][cell]];
+}
+
+// Take a piece back off the board; the cell goes back on the end of the
+// free list
+void boardRemove(Board *b, int cell, int player) {
+    Bits m = cellMask(b, cell);
+    b->pieces[player] &= ~m;
+    b->occupied &= ~m;
+    countLines(b, cell, player, -1);
+    for (int s = 0; s < SYMMETRIES; s++)
+        b->hashes[s] ^= zobristKeys[player][symmetryCells[b->size][s][cell]];
+
+    b->freeCells[b->freeCount] = (unsigned char)cell;
+    b->freeIndex[cell] = (unsigned char)b->freeCount;
+    b->freeCount++;
+}
+
+// Index of the player on a cell, -1 if empty
+int boardOwner(const Board *b, int cell) {
+    Bits m = cellMask(b, cell);
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        if (b->pieces[p] & m) return p;
+    return -1;
+}
+
+// Uniformly random empty cell, -1 if the board is full
+int boardRandomFreeCell(const Board *b) {
+    if (b->freeCount == 0) return -1;
+    return b->freeCells[rand() % b->freeCount];
+}
+
+// Any winLength run in one of the four directions. Each AND with a shifted
+// copy keeps only the bits that start a run one cell longer.
+int boardHasWon(const Board *b, int player) {
+    const int dirs[4] = {1, b->stride, b->stride + 1, b->stride - 1};
+    for (int d = 0; d < 4; d++) {
+        Bits run = b->pieces[player];
+        for (int k = 1; k < b->winLength && run; k++)
+            run &= b->pieces[player] >> (dirs[d] * k);
+        if (run) return 1;
+    }
+    return 0;
+}
+
+// Did the piece just played on cell complete a line? Only the lines
+// through that cell can have changed, and their counts say how full
+// each one is.
+int boardWinsAt(const Board *b, int cell, int player) {
+    const LineTable *t = boardLines(b);
+    const unsigned full = (unsigned)b->winLength << (4 * player);
+    const unsigned mask = 0xFu << (4 * player);
+    for (int i = 0; i < t->cellCount[cell]; i++)
+        if ((b->lineCounts[t->cellLines[cell][i]] & mask) == full) return 1;
+    return 0;
+}
+
+// Cells worth trying in a search: everything on small boards, otherwise
+// only cells touching a piece that is already down
+Bits boardCandidates(const Board *b) {
+    Bits occ = b->occupied, near;
+    if (b->size <= 4 || occ == 0)
+        return b->valid & ~occ;
+    near = occ << 1 | occ >> 1
+         | occ << b->stride | occ >> b->stride
+         | occ << (b->stride + 1) | occ >> (b->stride + 1)
+         | occ << (b->stride - 1) | occ >> (b->stride - 1);
+    return near & b->valid & ~occ;
+}
+
+// Empty cells that would complete a line for player
+Bits boardThreats(const Board *b, int player) {
+    const LineTable *t = boardLines(b);
+    const Bits mine = b->pieces[player];
+    const Bits empty = b->valid & ~b->occupied;
+    Bits threats = 0;
+    for (int i = 0; i < t->count; i++) {
+        Bits gap = t->lines[i] & ~mine;
+        if ((gap & (gap - 1)) == 0 && (gap & empty))
+            threats |= gap;
+    }
+    return threats;
+}
+
+// The symmetry that gives the position its smallest hash, which is the
+// canonical one: every rotation or reflection of a position picks the
+// same canonical form. The hash is that form's.
+int boardCanonical(const Board *b, uint64_t *hash) {
+    int best = 0;
+    for (int s = 1; s < SYMMETRIES; s++)
+        if (b->hashes[s] < b->hashes[best]) best = s;
+    if (hash) *hash = b->hashes[best];
+    return best;
+}
+
+// The position with every piece moved by symmetry
+void boardTransform(const Board *from, int symmetry, Board *to) {
+    boardInit(to, from->size);
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        for (Bits m = from->pieces[p]; m; m &= m - 1)
+            boardPlace(to, symmetryCell(from->size, symmetry, bitCell(from, bitsFirst(m))), p);
+}
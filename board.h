@@ -0,0 +1,132 @@
+#ifndef BOARD_H
+#define BOARD_H
+
+#include <stdint.h>
+
+#define MAX_SIZE 10
+#define MIN_SIZE 3
+#define MAX_PLAYERS 3
+#define MAX_CELLS (MAX_SIZE * MAX_SIZE)
+#define SYMMETRIES 8             // rotations and reflections of a square
+#define MAX_LINES 256            // 10x10 with 4 in a row has 238; a multiple of 16 for pattern.c
+#define MAX_CELL_LINES 16        // 4 directions x at most 4 segments each
+
+// One bit per cell. Rows are laid out with a stride of size+1 so the spare
+// bit at the end of every row stops shifted masks from wrapping into the
+// next row; 10 rows of 11 bits still fit in 128.
+typedef unsigned __int128 Bits;
+
+typedef struct {
+    int size;
+    int winLength;
+    int stride;
+    Bits valid;                  // every on-board cell
+    Bits occupied;               // union of all pieces
+    Bits pieces[MAX_PLAYERS];    // one mask per symbol (X, O, Z)
+    uint64_t hashes[SYMMETRIES]; // Zobrist hash of the pieces under each symmetry, [0] as is
+    int freeCount;               // number of empty cells
+    int liveLines;               // lines at most one player has pieces on
+    uint16_t lineCounts[MAX_LINES];  // pieces on each line, 4 bits per player; 0 past the last line
+    unsigned char freeCells[MAX_CELLS];  // empty cells, first freeCount valid
+    unsigned char freeIndex[MAX_CELLS];  // where each empty cell sits in freeCells
+} Board;
+
+// Every winning segment for one board size (the win length follows from
+// the size), and the segments through each cell. Built once, before main.
+typedef struct {
+    int count;
+    Bits lines[MAX_LINES];
+    unsigned char cellCount[MAX_CELLS];
+    unsigned char cellLines[MAX_CELLS][MAX_CELL_LINES];    // indexes into lines
+} LineTable;
+
+extern const char playerSymbols[MAX_PLAYERS];
+extern LineTable lineTables[MAX_SIZE + 1];
+extern uint64_t zobristKeys[MAX_PLAYERS][MAX_CELLS];
+
+// Where each cell of a size x size board lands under each symmetry:
+// symmetry s transposes if bit 2 is set, then flips the rows (bit 0) and
+// the columns (bit 1). symmetryInverse[s] undoes s.
+extern unsigned char symmetryCells[MAX_SIZE + 1][SYMMETRIES][MAX_CELLS];
+extern const unsigned char symmetryInverse[SYMMETRIES];
+
+// Cells are numbered row-major from 0, exactly as shown to players
+static inline int cellBit(const Board *b, int cell) {
+    return (cell / b->size) * b->stride + cell % b->size;
+}
+
+static inline Bits cellMask(const Board *b, int cell) {
+    return (Bits)1 << cellBit(b, cell);
+}
+
+// Inverse of cellBit
+static inline int bitCell(const Board *b, int bit) {
+    return (bit / b->stride) * b->size + bit % b->stride;
+}
+
+static inline int bitsCount(Bits m) {
+    return __builtin_popcountll((uint64_t)m) + __builtin_popcountll((uint64_t)(m >> 64));
+}
+
+// Lowest set bit of a non-empty mask
+static inline int bitsFirst(Bits m) {
+    uint64_t lo = (uint64_t)m;
+    return lo ? __builtin_ctzll(lo) : 64 + __builtin_ctzll((uint64_t)(m >> 64));
+}
+
+static inline const LineTable *boardLines(const Board *b) {
+    return &lineTables[b->size];
+}
+
+static inline int symmetryCell(int size, int symmetry, int cell) {
+    return symmetryCells[size][symmetry][cell];
+}
+
+// Small per-thread generator (splitmix64) for code that can't share rand()
+static inline uint64_t rngNext(uint64_t *state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [0, n) without a division
+static inline int rngBelow(uint64_t *state, int n) {
+    return (int)(((rngNext(state) >> 32) * (uint64_t)n) >> 32);
+}
+
+static inline int boardIsEmpty(const Board *b, int cell) {
+    return (b->occupied & cellMask(b, cell)) == 0;
+}
+
+static inline int boardIsFull(const Board *b) {
+    return b->freeCount == 0;
+}
+
+// Every line has pieces of two players on it, so nobody can win any more
+static inline int boardIsDead(const Board *b) {
+    return b->liveLines == 0;
+}
+
+// Over, one way or the other, unless someone has just won
+static inline int boardIsDrawn(const Board *b) {
+    return b->freeCount == 0 || b->liveLines == 0;
+}
+
+int  boardWinLength(int size);
+int  symbolIndex(char symbol);
+void boardInit(Board *b, int size);
+void boardPlace(Board *b, int cell, int player);
+// For throwaway boards (playouts): the hashes go stale, nothing else does
+void boardPlaceUnhashed(Board *b, int cell, int player);
+void boardRemove(Board *b, int cell, int player);
+int  boardOwner(const Board *b, int cell);
+int  boardRandomFreeCell(const Board *b);
+int  boardHasWon(const Board *b, int player);
+int  boardWinsAt(const Board *b, int cell, int player);
+Bits boardThreats(const Board *b, int player);
+Bits boardCandidates(const Board *b);
+int  boardCanonical(const Board *b, uint64_t *hash);
+void boardTransform(const Board *from, int symmetry, Board *to);
+
+#endif
@@ -0,0 +1,120 @@
+#include "game.h"
+#include "render.h"
+
+void gameInit(Game *g, int size, int players, FILE *log) {
+    boardInit(&g->board, size);
+    g->rules = rulesFor(size);
+    g->players = (unsigned char)players;
+    g->toMove = 0;
+    g->moveCount = 0;
+    g->redoCount = 0;
+    g->result = GAME_PLAYING;
+    g->log = log;
+    g->moveLog = NULL;
+    g->logStarted = 0;
+}
+
+// Play a cell for the player to move. On success the board state (and
+// the result, if the move ended the game) goes to the log and the turn
+// passes on.
+int gamePlay(Game *g, int cell) {
+    int player = g->toMove;
+    if (g->result != GAME_PLAYING) return MOVE_GAME_OVER;
+    if (cell < 0 || cell >= g->board.size * g->board.size) return MOVE_OUT_OF_RANGE;
+    if (!boardIsEmpty(&g->board, cell)) return MOVE_TAKEN;
+
+    boardPlace(&g->board, cell, player);
+    g->history[g->moveCount++] = (unsigned char)cell;
+    g->redoCount = 0;
+    if (g->rules->winsAt(&g->board, cell, player))
+        g->result = (signed char)player;
+    else if (boardIsDrawn(&g->board))
+        g->result = GAME_DRAW;
+    g->toMove = (unsigned char)((player + 1) % g->players);
+
+    if (g->moveLog) {
+        // The header waits for the first move so it records who started,
+        // and goes out once: taking that move back doesn't start a new game
+        if (!g->logStarted)
+            moveLogBegin(g->moveLog, g->board.size, g->players, player);
+        g->logStarted = 1;
+        moveLogMove(g->moveLog, cell);
+        if (g->result != GAME_PLAYING) moveLogEnd(g->moveLog, g->result);
+    }
+
+    if (g->log) {
+        gameSaveState(g);
+        if (g->result == GAME_DRAW)
+            fprintf(g->log, "Game ended in a draw.\n");
+        else if (g->result != GAME_PLAYING)
+            fprintf(g->log, "Player %c wins!\n", playerSymbols[player]);
+    }
+    return MOVE_OK;
+}
+
+// Take back the last move of a game still in play. The board, its
+// hashes and line counts are unwound in place, and the move is kept for
+// gameRedo until a different one is played. Returns the cell, or -1 if
+// there is nothing to take back.
+int gameUndo(Game *g) {
+    int cell, player;
+    if (g->result != GAME_PLAYING || g->moveCount == 0) return -1;
+    cell = g->history[--g->moveCount];
+    player = (g->toMove + g->players - 1) % g->players;
+    boardRemove(&g->board, cell, player);
+    g->toMove = (unsigned char)player;
+    g->redoCount++;
+
+    if (g->moveLog) moveLogUndo(g->moveLog);
+    if (g->log) {
+        fprintf(g->log, "Move taken back.\n");
+        gameSaveState(g);
+    }
+    return cell;
+}
+
+// Play the last move taken back again; returns the cell or -1
+int gameRedo(Game *g) {
+    int redo = g->redoCount, cell;
+    if (redo == 0 || g->result != GAME_PLAYING) return -1;
+    cell = g->history[g->moveCount];
+    gamePlay(g, cell);
+    g->redoCount = (unsigned char)(redo - 1);
+    return cell;
+}
+
+int gameHasWon(const Game *g, int player) {
+    return g->result == player;
+}
+
+int gameIsFull(const Game *g) {
+    return boardIsFull(&g->board);
+}
+
+// Empty cells show their number, taken ones the player's symbol
+static void printCell(const Game *g, FILE *out, const char *fmt, int cell) {
+    int owner = boardOwner(&g->board, cell);
+    char text[12];
+    if (owner < 0)
+        sprintf(text, "%d", cell);
+    else
+        sprintf(text, "%c", playerSymbols[owner]);
+    fprintf(out, fmt, text);
+}
+
+// Display the current board
+void gameShow(const Game *g, FILE *out) {
+    char frame[RENDER_MAX_FRAME];
+    fwrite(frame, 1, renderFrame(&g->board, frame), out);
+}
+
+// Save the board state to the log
+void gameSaveState(const Game *g) {
+    int size = g->board.size;
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++)
+            printCell(g, g->log, "%s ", i * size + j);
+        fprintf(g->log, "\n");
+    }
+    fprintf(g->log, "---------------------\n");
+}
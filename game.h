@@ -0,0 +1,42 @@
+#ifndef GAME_H
+#define GAME_H
+
+#include <stdio.h>
+#include "board.h"
+#include "movelog.h"
+#include "rules.h"
+
+// Game.result while nobody has won yet, and once nobody can: the board
+// is full or every line is blocked
+#define GAME_PLAYING -1
+#define GAME_DRAW -2
+
+// What gamePlay made of a move
+enum { MOVE_OK, MOVE_OUT_OF_RANGE, MOVE_TAKEN, MOVE_GAME_OVER };
+
+// Everything one game needs, with no globals behind it, so a process can
+// keep as many games alive as it has memory for (about a kilobyte each)
+typedef struct {
+    Board board;
+    const Rules *rules;               // compiled for this size, if it's a common one
+    unsigned char players;            // 2 or 3
+    unsigned char toMove;             // index into playerSymbols
+    unsigned char moveCount;
+    unsigned char redoCount;          // taken-back moves kept after moveCount
+    signed char result;               // GAME_PLAYING, GAME_DRAW or the winner
+    unsigned char history[MAX_CELLS]; // cells in the order they were played, then any to redo
+    FILE *log;                        // text log, NULL for none
+    MoveLog *moveLog;                 // binary log, NULL for none
+    unsigned char logStarted;         // moveLog has this game's header
+} Game;
+
+void gameInit(Game *g, int size, int players, FILE *log);
+int  gamePlay(Game *g, int cell);
+int  gameUndo(Game *g);
+int  gameRedo(Game *g);
+int  gameHasWon(const Game *g, int player);
+int  gameIsFull(const Game *g);
+void gameShow(const Game *g, FILE *out);
+void gameSaveState(const Game *g);
+
+#endif
@@ -0,0 +1,335 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+#include "board.h"
+
+// Load generator for server.c: keeps a fixed number of games going over a
+// handful of connections, answers every TURN with a random legal move,
+// and times each move from sending it until the server hands the turn
+// back, so the computer seats' replies are included. -a picks which
+// seats the server plays: O by default in mode 2, O and Z in mode 3, or
+// - for none.
+//
+//   gcc -O2 -o loadgen loadgen.c board.c
+//   ./loadgen -p 7777 -c 100 -g 10000 -T 30 -s 10
+//   ./loadgen -p 7777 -c 100 -g 10000 -T 30 -s 7 -m 3 -a OZ
+
+typedef struct {
+    Board board;
+    int conn;
+    long long id;                  // server's game id, -1 while waiting for OK
+    double sentAt;                 // when our last MOVE went out, 0 if none
+} LoadGame;
+
+typedef struct {
+    int fd;
+    char in[1 << 16];
+    size_t inLen;
+    char out[1 << 16];
+    size_t outLen;
+    int *awaitingOk;               // games whose NEW hasn't been answered, in order
+    int awaitHead, awaitCount, awaitCap;
+} LoadConn;
+
+static LoadGame *games;
+static LoadConn *conns;
+static long long *mapKeys;         // server game id -> our game, open addressing
+static int *mapValues;
+static size_t mapMask;
+static double *latencies;
+static size_t latencyCount, latencyCap;
+static long long gamesFinished, movesSent, computerMoves;
+static int boardSize = 3, mode = 2, draining;
+static const char *computers;      // NEW's computer seats, "-" for none
+static int isComputer[MAX_PLAYERS];
+static uint64_t rng = 0x10AD;
+
+static size_t mapSlot(long long id) {
+    uint64_t h = (uint64_t)id * 0x9E3779B97F4A7C15ULL;
+    return (size_t)(h >> 20) & mapMask;
+}
+
+static void mapPut(long long id, int game) {
+    size_t i = mapSlot(id);
+    while (mapKeys[i] >= 0) i = (i + 1) & mapMask;
+    mapKeys[i] = id;
+    mapValues[i] = game;
+}
+
+static int mapGet(long long id) {
+    for (size_t i = mapSlot(id); mapKeys[i] >= 0; i = (i + 1) & mapMask)
+        if (mapKeys[i] == id) return mapValues[i];
+    return -1;
+}
+
+// Backward-shift delete, so lookups never need tombstones
+static void mapDelete(long long id) {
+    size_t i = mapSlot(id), j;
+    while (mapKeys[i] != id) {
+        if (mapKeys[i] < 0) return;
+        i = (i + 1) & mapMask;
+    }
+    for (j = (i + 1) & mapMask; mapKeys[j] >= 0; j = (j + 1) & mapMask) {
+        size_t home = mapSlot(mapKeys[j]);
+        if (((j - home) & mapMask) >= ((j - i) & mapMask)) {
+            mapKeys[i] = mapKeys[j];
+            mapValues[i] = mapValues[j];
+            i = j;
+        }
+    }
+    mapKeys[i] = -1;
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void flushOut(LoadConn *c) {
+    size_t sent = 0;
+    while (sent < c->outLen) {
+        ssize_t n = write(c->fd, c->out + sent, c->outLen - sent);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) continue;
+            perror("write");
+            exit(1);
+        }
+        sent += n;
+    }
+    c->outLen = 0;
+}
+
+static void queueOut(LoadConn *c, const char *text, int n) {
+    if (c->outLen + n > sizeof c->out) flushOut(c);
+    memcpy(c->out + c->outLen, text, n);
+    c->outLen += n;
+}
+
+static void newGame(int g) {
+    LoadConn *c = &conns[games[g].conn];
+    char line[32];
+    int n = snprintf(line, sizeof line, "NEW %d %d %s\n", boardSize, mode, computers);
+    if (c->awaitCount == c->awaitCap) {
+        int *grown = malloc(2 * c->awaitCap * sizeof(int));
+        for (int i = 0; i < c->awaitCount; i++)
+            grown[i] = c->awaitingOk[(c->awaitHead + i) % c->awaitCap];
+        free(c->awaitingOk);
+        c->awaitingOk = grown;
+        c->awaitHead = 0;
+        c->awaitCap *= 2;
+    }
+    c->awaitingOk[(c->awaitHead + c->awaitCount++) % c->awaitCap] = g;
+    boardInit(&games[g].board, boardSize);
+    games[g].id = -1;
+    games[g].sentAt = 0;
+    queueOut(c, line, n);
+}
+
+// Out of memory for more samples, the percentiles come from the ones kept
+static void recordLatency(LoadGame *game) {
+    if (game->sentAt == 0) return;
+    if (latencyCount == latencyCap) {
+        size_t cap = latencyCap ? latencyCap * 2 : 1 << 16;
+        double *grown = realloc(latencies, cap * sizeof *grown);
+        if (grown) {
+            latencies = grown;
+            latencyCap = cap;
+        }
+    }
+    if (latencyCount < latencyCap) latencies[latencyCount++] = nowSeconds() - game->sentAt;
+    game->sentAt = 0;
+}
+
+static void handleLine(LoadConn *c, char *line) {
+    long long id;
+    int cell, a, b;
+    char symbol;
+    if (sscanf(line, "OK %lld %d %d", &id, &a, &b) == 3) {
+        int g = c->awaitingOk[c->awaitHead];
+        c->awaitHead = (c->awaitHead + 1) % c->awaitCap;
+        c->awaitCount--;
+        games[g].id = id;
+        mapPut(id, g);
+    } else if (sscanf(line, "MOVED %lld %c %d", &id, &symbol, &cell) == 3) {
+        LoadGame *game = &games[mapGet(id)];
+        boardPlace(&game->board, cell, symbolIndex(symbol));
+        computerMoves += isComputer[symbolIndex(symbol)];
+    } else if (sscanf(line, "TURN %lld %c", &id, &symbol) == 2) {
+        LoadGame *game = &games[mapGet(id)];
+        char out[48];
+        int n;
+        recordLatency(game);
+        if (draining) return;
+        cell = game->board.freeCells[rngBelow(&rng, game->board.freeCount)];
+        n = snprintf(out, sizeof out, "MOVE %lld %d\n", id, cell);
+        game->sentAt = nowSeconds();
+        movesSent++;
+        queueOut(c, out, n);
+    } else if (sscanf(line, "WIN %lld", &id) == 1 || sscanf(line, "DRAW %lld", &id) == 1) {
+        int g = mapGet(id);
+        mapDelete(id);
+        recordLatency(&games[g]);
+        gamesFinished++;
+        if (!draining) newGame(g);
+    } else {
+        fprintf(stderr, "server: %s\n", line);
+    }
+}
+
+static int readConn(LoadConn *c) {
+    while (1) {
+        ssize_t n = read(c->fd, c->in + c->inLen, sizeof c->in - c->inLen);
+        char *start = c->in, *nl;
+        if (n == 0) return 0;
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        c->inLen += n;
+        while ((nl = memchr(start, '\n', c->in + c->inLen - start))) {
+            *nl = '\0';
+            handleLine(c, start);
+            start = nl + 1;
+        }
+        c->inLen -= start - c->in;
+        memmove(c->in, start, c->inLen);
+    }
+}
+
+static int connectTo(int port, const char *unixPath) {
+    int fd, one = 1;
+    if (unixPath) {
+        struct sockaddr_un addr = {0};
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, unixPath, sizeof addr.sun_path - 1);
+        if (connect(fd, (struct sockaddr *)&addr, sizeof addr) < 0) return -1;
+    } else {
+        struct sockaddr_in addr = {0};
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        if (connect(fd, (struct sockaddr *)&addr, sizeof addr) < 0) return -1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+static int compareDoubles(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(double p) {
+    size_t i = (size_t)(p * (latencyCount - 1));
+    return latencies[i] * 1e3;
+}
+
+int main(int argc, char *argv[]) {
+    int port = 0, connCount = 100, gameCount = 10000, opt, epfd;
+    double seconds = 10, start, end;
+    const char *unixPath = NULL;
+    struct epoll_event events[256];
+
+    while ((opt = getopt(argc, argv, "p:u:c:g:T:s:m:a:")) != -1) {
+        switch (opt) {
+        case 'p': port = atoi(optarg); break;
+        case 'u': unixPath = optarg; break;
+        case 'c': connCount = atoi(optarg); break;
+        case 'g': gameCount = atoi(optarg); break;
+        case 'T': seconds = atof(optarg); break;
+        case 's': boardSize = atoi(optarg); break;
+        case 'm': mode = atoi(optarg); break;
+        case 'a': computers = optarg; break;
+        default:
+            fprintf(stderr, "usage: %s (-p port | -u socket) [-c connections] [-g games]\n"
+                            "          [-T seconds] [-s size] [-m mode] [-a computer symbols]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (!computers) computers = (mode == 3) ? "OZ" : "O";
+    for (const char *p = computers; strcmp(computers, "-") != 0 && *p; p++) {
+        int player = symbolIndex(*p);
+        if (player < 0 || strlen(computers) > 3) {
+            fprintf(stderr, "-a takes computer symbols out of XOZ, or - for none.\n");
+            return 1;
+        }
+        isComputer[player] = 1;
+    }
+    if ((!port && !unixPath) || connCount < 1 || gameCount < connCount) {
+        fprintf(stderr, "Need a server address and at least one game per connection.\n");
+        return 1;
+    }
+
+    games = calloc(gameCount, sizeof *games);
+    conns = calloc(connCount, sizeof *conns);
+    for (mapMask = 1; mapMask < 4 * (size_t)gameCount; mapMask *= 2) {}
+    mapKeys = malloc(mapMask * sizeof *mapKeys);
+    mapValues = malloc(mapMask * sizeof *mapValues);
+    memset(mapKeys, 0xFF, mapMask * sizeof *mapKeys);
+    mapMask--;
+    epfd = epoll_create1(0);
+    for (int i = 0; i < connCount; i++) {
+        struct epoll_event ev = {0};
+        conns[i].fd = connectTo(port, unixPath);
+        if (conns[i].fd < 0) {
+            perror("connect");
+            return 1;
+        }
+        conns[i].awaitCap = 64;
+        conns[i].awaitingOk = malloc(conns[i].awaitCap * sizeof(int));
+        ev.events = EPOLLIN;
+        ev.data.u32 = (uint32_t)i;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, conns[i].fd, &ev);
+    }
+
+    start = nowSeconds();
+    end = start + seconds;
+    for (int g = 0; g < gameCount; g++) {
+        games[g].conn = g % connCount;
+        newGame(g);
+    }
+    for (int i = 0; i < connCount; i++)
+        flushOut(&conns[i]);
+
+    // Stop starting moves at the deadline, then wait a moment for replies
+    while (1) {
+        double now = nowSeconds();
+        int n;
+        if (now > end && !draining) draining = 1;
+        if (draining && now > end + 2) break;
+        n = epoll_wait(epfd, events, 256, 100);
+        for (int i = 0; i < n; i++) {
+            LoadConn *c = &conns[events[i].data.u32];
+            if (!readConn(c)) {
+                fprintf(stderr, "Server closed the connection.\n");
+                return 1;
+            }
+            flushOut(c);
+        }
+    }
+
+    printf("%d games in flight over %d connections, %dx%d mode %d, computers %s, %.1f s\n",
+           gameCount, connCount, boardSize, boardSize, mode, computers, seconds);
+    printf("%lld moves (%.0f/s), %lld computer moves (%.0f/s), %lld games finished (%.0f/s)\n",
+           movesSent, movesSent / seconds, computerMoves, computerMoves / seconds,
+           gamesFinished, gamesFinished / seconds);
+    if (latencyCount) {
+        qsort(latencies, latencyCount, sizeof *latencies, compareDoubles);
+        printf("move latency ms, computer replies included: p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+               percentile(0.50), percentile(0.90), percentile(0.99), percentile(1.0));
+    }
+    return 0;
+}
@@ -0,0 +1,350 @@
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "board.h"
+
+// Statistics over text logs in the game_log.txt format: one board
+// snapshot per move, each followed by a line of dashes, and a
+// "Player X wins!" or "Game ended in a draw." line when a game ends.
+// Files are mapped and parsed in place, and every move is recovered by
+// comparing a snapshot with the one before it: the two are byte for byte
+// the same apart from one cell number turned into a symbol, so finding
+// the move is a compare and a count of the spaces in front of it. Only
+// the first board of a game is parsed cell by cell.
+//
+//   gcc -O2 -o loganalyze loganalyze.c board.c
+//   ./loganalyze game_log.txt archive/*.txt
+
+// Pieces per symbol, bit n for cell n (row-major, no padding column)
+typedef struct {
+    int size;
+    int cells;                      // tokens read so far
+    int rows;
+    Bits pieces[MAX_PLAYERS];
+} Snapshot;
+
+// The game being pieced together
+typedef struct {
+    int open;
+    int size;
+    int moves;
+    int firstCell;
+    int sawZ;
+    int takenBack;                  // "Move taken back." came before this snapshot
+    const char *last;               // previous snapshot, in the mapping
+    size_t lastLength;              // up to its line of dashes
+} Current;
+
+typedef struct {
+    long long games, finished, draws, unfinished, partial, bad;
+    long long wins[MAX_PLAYERS];
+    long long played[MAX_PLAYERS];     // games each symbol took part in
+    long long lengths[MAX_CELLS + 1];
+    long long bySize[MAX_SIZE + 1];
+    long long openings[MAX_SIZE + 1][MAX_CELLS];
+    long long bytes;
+} Stats;
+
+static Stats stats;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Openings are counted up to symmetry: a corner is a corner whichever
+// one it is. Each cell stands for the smallest cell it maps onto.
+static int canonicalCell(int size, int cell) {
+    int best = cell;
+    for (int s = 1; s < SYMMETRIES; s++)
+        if (symmetryCell(size, s, cell) < best) best = symmetryCell(size, s, cell);
+    return best;
+}
+
+// Count a game once it ends; result is the winner, -2 for a draw or -1
+// when the log just stops
+static void finishGame(Current *g, int result) {
+    if (!g->open) return;
+    stats.games++;
+    stats.bySize[g->size]++;
+    stats.lengths[g->moves]++;
+    if (g->firstCell >= 0) stats.openings[g->size][canonicalCell(g->size, g->firstCell)]++;
+    stats.played[0]++;
+    stats.played[1]++;
+    if (g->sawZ) stats.played[2]++;
+    if (result == -2) {
+        stats.draws++;
+        stats.finished++;
+    } else if (result >= 0) {
+        stats.wins[result]++;
+        stats.finished++;
+    } else
+        stats.unfinished++;
+    g->open = 0;
+}
+
+// A snapshot that doesn't follow on from the last one starts a game
+static void startGame(Current *g, const Snapshot *s) {
+    Bits all = s->pieces[0] | s->pieces[1] | s->pieces[2];
+    int count = bitsCount(all);
+    finishGame(g, -1);
+    g->open = 1;
+    g->size = s->size;
+    g->moves = count;
+    g->firstCell = -1;
+    g->sawZ = s->pieces[2] != 0;
+    // A game that starts mid-way still counts, just without an opening
+    if (count == 1) g->firstCell = bitsFirst(all);
+    else if (count > 1) stats.partial++;
+}
+
+// A snapshot after a move was taken back rewinds the open game
+static void rewindGame(Current *g, const Snapshot *s) {
+    g->moves = bitsCount(s->pieces[0] | s->pieces[1] | s->pieces[2]);
+    if (g->moves == 0) g->firstCell = -1;
+}
+
+// What a byte means inside the board rows; digits are CHAR_OTHER
+enum { CHAR_OTHER, CHAR_SPACE, CHAR_NEWLINE, CHAR_END, CHAR_PIECE };
+static unsigned char charClass[256];
+
+static void addPiece(Snapshot *s, int player, int cell) {
+    if (cell < MAX_CELLS) s->pieces[player] |= (Bits)1 << cell;
+}
+
+// Count one byte of a board row
+static int scanByte(Snapshot *s, int k) {
+    if (k == CHAR_SPACE) s->cells++;
+    else if (k == CHAR_NEWLINE) {
+        if (s->rows++ == 0) s->size = s->cells;
+    } else if (k >= CHAR_PIECE)
+        addPiece(s, k - CHAR_PIECE, s->cells);
+    return k == CHAR_END;
+}
+
+// Read the rows of one snapshot, from p up to its line of dashes, and
+// return where the dashes start (or end, if the file stops first).
+// Every token in a row is followed by one space, so spaces count cells
+// and a symbol always sits in the cell the spaces so far point at. With
+// SSE2 that is done 16 bytes at a time from byte masks.
+static const char *scanRows(const char *p, const char *end, Snapshot *s) {
+#ifdef __SSE2__
+    const __m128i space = _mm_set1_epi8(' '), newline = _mm_set1_epi8('\n');
+    const __m128i dash = _mm_set1_epi8('-');
+    __m128i symbols[MAX_PLAYERS];
+    for (int player = 0; player < MAX_PLAYERS; player++)
+        symbols[player] = _mm_set1_epi8(playerSymbols[player]);
+    while (end - p >= 16) {
+        __m128i v = _mm_loadu_si128((const __m128i *)p);
+        unsigned stop = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, dash));
+        unsigned keep = stop ? (stop & -stop) - 1 : 0xFFFF;
+        unsigned spaces = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, space)) & keep;
+        unsigned lines = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, newline)) & keep;
+        for (int player = 0; player < MAX_PLAYERS; player++) {
+            unsigned found = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(v, symbols[player])) & keep;
+            for (; found; found &= found - 1) {
+                unsigned before = (found & -found) - 1;
+                addPiece(s, player, s->cells + __builtin_popcount(spaces & before));
+            }
+        }
+        if (lines && s->rows == 0)
+            s->size = s->cells + __builtin_popcount(spaces & ((lines & -lines) - 1));
+        s->cells += __builtin_popcount(spaces);
+        s->rows += __builtin_popcount(lines);
+        if (stop) return p + __builtin_ctz(stop);
+        p += 16;
+    }
+#endif
+    for (; p < end; p++)
+        if (scanByte(s, charClass[(unsigned char)*p])) return p;
+    return end;
+}
+
+// Offset of the first byte where a and b differ, or n
+static size_t firstDifference(const char *a, const char *b, size_t n) {
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 16 <= n; i += 16) {
+        __m128i x = _mm_loadu_si128((const __m128i *)(a + i));
+        __m128i y = _mm_loadu_si128((const __m128i *)(b + i));
+        unsigned same = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, y));
+        if (same != 0xFFFF) return i + __builtin_ctz(~same);
+    }
+#endif
+    while (i < n && a[i] == b[i]) i++;
+    return i;
+}
+
+static int countSpaces(const char *p, size_t n) {
+    size_t i = 0;
+    int count = 0;
+#ifdef __SSE2__
+    const __m128i space = _mm_set1_epi8(' ');
+    for (; i + 16 <= n; i += 16)
+        count += __builtin_popcount((unsigned)_mm_movemask_epi8(
+                     _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(p + i)), space)));
+#endif
+    for (; i < n; i++) count += p[i] == ' ';
+    return count;
+}
+
+static int isDigit(char c) {
+    return c >= '0' && c <= '9';
+}
+
+// If the snapshot at p is the last one with one more move, count the
+// move and return where its dashes start; otherwise return NULL
+static const char *continueGame(Current *g, const char *p, const char *end) {
+    const char *last = g->last;
+    size_t n = g->lastLength, d, digits = 0, length;
+    int player;
+    if ((size_t)(end - p) <= n) return NULL;
+    d = firstDifference(last, p, n);
+    if (d == n || (d > 0 && last[d - 1] != ' ' && last[d - 1] != '\n')) return NULL;
+    player = charClass[(unsigned char)p[d]] - CHAR_PIECE;
+    if (player < 0) return NULL;
+    while (d + digits < n && isDigit(last[d + digits])) digits++;
+    // "12 " became "X ": the rest of the board moved back by digits - 1
+    length = n - digits + 1;
+    if (digits == 0 || p[length] != '-' ||
+        memcmp(last + d + digits, p + d + 1, n - d - digits) != 0)
+        return NULL;
+    g->moves++;
+    if (g->moves == 1) g->firstCell = countSpaces(p, d);
+    g->sawZ |= player == 2;
+    return p + length;
+}
+
+// Walk one mapped file without copying anything out of the mapping
+static void parse(const char *p, const char *end) {
+    Current game = {0};
+    while (p < end) {
+        const char *eol;
+        if (*p == 'P' && end - p > 8 && memcmp(p, "Player ", 7) == 0) {
+            finishGame(&game, symbolIndex(p[7]));
+        } else if (*p == 'G' && end - p >= 21 && memcmp(p, "Game ended in a draw.", 21) == 0) {
+            finishGame(&game, -2);
+        } else if (*p == 'M' && end - p >= 16 && memcmp(p, "Move taken back.", 16) == 0) {
+            game.takenBack = game.open;
+        } else if (*p != '-' && *p != '\n') {
+            const char *dashes = game.open && !game.takenBack ? continueGame(&game, p, end) : NULL;
+            if (!dashes) {
+                Snapshot snap = {0};
+                dashes = scanRows(p, end, &snap);
+                if (dashes == end) break;     // cut off mid-board
+                if (snap.rows == snap.size && snap.cells == snap.size * snap.size &&
+                    snap.size >= MIN_SIZE && snap.size <= MAX_SIZE) {
+                    if (game.takenBack && snap.size == game.size) rewindGame(&game, &snap);
+                    else startGame(&game, &snap);
+                }
+                else {
+                    stats.bad++;
+                    finishGame(&game, -1);
+                }
+            }
+            game.takenBack = 0;
+            game.last = p;
+            game.lastLength = (size_t)(dashes - p);
+            p = dashes;
+        }
+        eol = memchr(p, '\n', (size_t)(end - p));
+        p = eol ? eol + 1 : end;
+    }
+    finishGame(&game, -1);
+}
+
+static int analyze(const char *path) {
+    struct stat st;
+    const char *data;
+    int fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        perror(path);
+        if (fd >= 0) close(fd);
+        return 0;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return 1;
+    }
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        perror(path);
+        return 0;
+    }
+    posix_madvise((void *)data, (size_t)st.st_size, POSIX_MADV_SEQUENTIAL);
+    parse(data, data + st.st_size);
+    munmap((void *)data, (size_t)st.st_size);
+    stats.bytes += st.st_size;
+    return 1;
+}
+
+static void report(double elapsed) {
+    printf("%lld games in %.1f MB, %.3f s (%.0f MB/s)\n", stats.games, stats.bytes / 1e6,
+           elapsed, stats.bytes / 1e6 / (elapsed > 0 ? elapsed : 1e-9));
+    if (stats.games == 0) return;
+    printf("Finished: %lld, unfinished: %lld, started mid-game: %lld, bad snapshots: %lld\n",
+           stats.finished, stats.unfinished, stats.partial, stats.bad);
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        if (stats.played[p])
+            printf("%c wins: %lld of %lld games (%.2f%%)\n", playerSymbols[p], stats.wins[p],
+                   stats.played[p], 100.0 * stats.wins[p] / stats.played[p]);
+    printf("Draws: %lld (%.2f%%)\n", stats.draws, 100.0 * stats.draws / stats.games);
+
+    printf("Length histogram:");
+    for (int n = 0; n <= MAX_CELLS; n++)
+        if (stats.lengths[n]) printf(" %d:%lld", n, stats.lengths[n]);
+    printf("\n");
+
+    // Opening frequencies laid out like the board, each symmetry class on
+    // its smallest cell, so only the top-left triangle shows
+    for (int size = MIN_SIZE; size <= MAX_SIZE; size++) {
+        long long openings = 0;
+        if (!stats.bySize[size]) continue;
+        for (int cell = 0; cell < size * size; cell++)
+            openings += stats.openings[size][cell];
+        printf("\n%dx%d: %lld games, opening cell up to symmetry, %% of %lld:\n", size, size,
+               stats.bySize[size], openings);
+        for (int i = 0; i < (size + 1) / 2; i++) {
+            int gap = 0;
+            printf("  ");
+            for (int j = 0; j < size; j++) {
+                if (canonicalCell(size, i * size + j) != i * size + j) {
+                    gap++;
+                    continue;
+                }
+                printf("%*s %5.1f", 6 * gap, "", openings ? 100.0 * stats.openings[size][i * size + j] / openings : 0.0);
+                gap = 0;
+            }
+            printf("\n");
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    double start;
+    int ok = 1;
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s game_log.txt...\n", argv[0]);
+        return 1;
+    }
+    charClass[' '] = CHAR_SPACE;
+    charClass['\n'] = CHAR_NEWLINE;
+    charClass['-'] = CHAR_END;
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        charClass[(unsigned char)playerSymbols[p]] = (unsigned char)(CHAR_PIECE + p);
+    start = nowSeconds();
+    for (int i = 1; i < argc; i++)
+        ok &= analyze(argv[i]);
+    report(nowSeconds() - start);
+    return ok ? 0 : 1;
+}
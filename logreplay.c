@@ -0,0 +1,107 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "movelog.h"
+#include "render.h"
+
+// Random access to an appended binary log through its index:
+//
+//   gcc -O2 -o logreplay logreplay.c movelog.c render.c board.c -lpthread
+//   ./logreplay game_log.bin              totals over every game
+//   ./logreplay game_log.bin 1234 [ply]   board of game 1234 after ply moves
+//   ./logreplay -i game_log.bin           rebuild game_log.idx from the log
+//
+// The index is the log's name with .idx in place of .bin.
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void indexPathFor(const char *logPath, char *out, size_t outSize) {
+    size_t n = strlen(logPath);
+    if (n > 4 && strcmp(logPath + n - 4, ".bin") == 0) n -= 4;
+    snprintf(out, outSize, "%.*s.idx", (int)n, logPath);
+}
+
+// One pass over every game: results and lengths
+static void summarize(const LogView *view) {
+    long long wins[MAX_PLAYERS] = {0}, draws = 0, unfinished = 0, moves = 0, bad = 0;
+    double start = nowSeconds(), elapsed;
+    MoveLogGame game;
+    for (size_t id = 0; id < view->games; id++) {
+        if (!logViewGame(view, id, &game)) {
+            bad++;
+            continue;
+        }
+        moves += game.moveCount;
+        if (game.result == -2) draws++;
+        else if (game.result < 0) unfinished++;
+        else wins[game.result]++;
+    }
+    elapsed = nowSeconds() - start;
+    printf("%zu games (%zu indexed), %zu bytes, scanned in %.3f s (%.0f games/s)\n",
+           view->games, view->indexed, view->length, elapsed, view->games / (elapsed > 0 ? elapsed : 1e-9));
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        printf("%c wins: %lld\n", playerSymbols[p], wins[p]);
+    printf("Draws: %lld\nUnfinished: %lld\n", draws, unfinished);
+    if (bad) printf("Unreadable: %lld\n", bad);
+    if (view->games) printf("Average length: %.2f moves\n", (double)moves / view->games);
+}
+
+static int showGame(const LogView *view, size_t id, int ply) {
+    char frame[RENDER_MAX_FRAME];
+    MoveLogGame game;
+    Board b;
+    if (!logViewGame(view, id, &game)) {
+        fprintf(stderr, "No game %zu (the log has %zu).\n", id, view->games);
+        return 1;
+    }
+    if (ply < 0 || ply > game.moveCount) ply = game.moveCount;
+    printf("Game %zu: %dx%d, %d players, %c first, %d moves, ", id, game.size, game.size,
+           game.players, playerSymbols[game.firstPlayer], game.moveCount);
+    if (game.result == -2) printf("draw\n");
+    else if (game.result < 0) printf("unfinished\n");
+    else printf("%c won\n", playerSymbols[game.result]);
+    printf("Moves:");
+    for (int i = 0; i < game.moveCount; i++)
+        printf(" %c%d", playerSymbols[(game.firstPlayer + i) % game.players], game.moves[i]);
+    printf("\nAfter %d moves:\n", ply);
+    moveLogReplay(&game, ply, &b);
+    fwrite(frame, 1, renderFrame(&b, frame), stdout);
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    char indexPath[4096];
+    int rebuild = argc > 1 && strcmp(argv[1], "-i") == 0, status = 0;
+    LogView view;
+
+    if (argc < 2 + rebuild) {
+        fprintf(stderr, "usage: %s [-i] game_log.bin [game [ply]]\n", argv[0]);
+        return 1;
+    }
+    indexPathFor(argv[1 + rebuild], indexPath, sizeof indexPath);
+    if (!logViewOpen(&view, argv[1 + rebuild], rebuild ? NULL : indexPath)) {
+        fprintf(stderr, "Couldn't open %s.\n", argv[1 + rebuild]);
+        return 1;
+    }
+
+    if (rebuild) {
+        FILE *out = fopen(indexPath, "wb");
+        if (!out || !logViewWriteIndex(&view, out)) {
+            fprintf(stderr, "Couldn't write %s.\n", indexPath);
+            status = 1;
+        } else
+            printf("Indexed %zu games.\n", view.games);
+        if (out) fclose(out);
+    } else if (argc > 2)
+        status = showGame(&view, strtoull(argv[2], NULL, 10), argc > 3 ? atoi(argv[3]) : -1);
+    else
+        summarize(&view);
+    logViewClose(&view);
+    return status;
+}
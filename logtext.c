@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include "game.h"
+
+// Turns a binary log from part03 back into the text game_log.txt format by
+// replaying every game through a Game with a text log attached:
+//
+//   gcc -O2 -o logtext logtext.c game.c render.c movelog.c board.c rules.c -lpthread
+//   ./logtext game_log.bin > game_log.txt
+
+int main(int argc, char *argv[]) {
+    MoveLogGame record;
+    Game game;
+    FILE *in;
+    int status, games = 0;
+
+    if (argc != 2) {
+        fprintf(stderr, "usage: %s game_log.bin > game_log.txt\n", argv[0]);
+        return 1;
+    }
+    in = fopen(argv[1], "rb");
+    if (!in) {
+        perror(argv[1]);
+        return 1;
+    }
+    while ((status = moveLogRead(in, &record)) == 1) {
+        gameInit(&game, record.size, record.players, stdout);
+        game.toMove = (unsigned char)record.firstPlayer;
+        for (int i = 0; i < record.moveCount; i++) {
+            int result = gamePlay(&game, record.moves[i]);
+            // Logs from before games stopped at a blocked board play on
+            // to a full one; the text ends at the draw
+            if (result == MOVE_GAME_OVER && game.result == GAME_DRAW)
+                break;
+            if (result != MOVE_OK) {
+                fprintf(stderr, "Game %d: illegal move %d at ply %d.\n", games + 1, record.moves[i], i);
+                return 1;
+            }
+        }
+        games++;
+    }
+    fclose(in);
+    if (status < 0) {
+        fprintf(stderr, "Game %d: not a valid log record.\n", games + 1);
+        return 1;
+    }
+    return 0;
+}
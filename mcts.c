@@ -0,0 +1,319 @@
+#define _POSIX_C_SOURCE 200809L
+#include <limits.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "mcts.h"
+
+#define NODE_LEAF 0
+#define NODE_EXPANDING 1
+#define NODE_EXPANDED 2
+
+#define VIRTUAL_LOSS 3      // visits charged to a node while a playout is below it
+#define EXPAND_AFTER 2      // visits a leaf needs before it gets children
+#define POINT 6             // a whole point in score units; 2 and 3 players split it evenly
+
+typedef struct {
+    Mcts *m;
+    uint64_t rng;
+    long long playouts;
+} MctsWorker;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+int mctsInit(Mcts *m, const MctsConfig *config) {
+    memset(m, 0, sizeof *m);
+    m->config = *config;
+    if (m->config.threads < 1) m->config.threads = 1;
+    if (m->config.exploration <= 0) m->config.exploration = 1.0;
+    if (m->config.maxNodes < 2 * MAX_CELLS) m->config.maxNodes = 2 * MAX_CELLS;
+    m->pool = malloc(m->config.maxNodes * sizeof(MctsNode));
+    m->spare = malloc(m->config.maxNodes * sizeof(MctsNode));
+    if (!m->pool || !m->spare) {
+        mctsFree(m);
+        return 0;
+    }
+    return 1;
+}
+
+void mctsFree(Mcts *m) {
+    free(m->pool);
+    free(m->spare);
+    m->pool = m->spare = NULL;
+}
+
+static void resetTree(Mcts *m, const Board *b, int player) {
+    MctsNode *root = &m->pool[0];
+    memset(root, 0, sizeof *root);
+    root->firstChild = -1;
+    root->player = (uint8_t)((player + m->players - 1) % m->players);
+    m->used = 1;
+    m->rootBoard = *b;
+    m->rootPlayer = player;
+    m->rootValid = 1;
+}
+
+// Copy the subtree under node to the front of the spare pool, breadth
+// first so every family of children stays contiguous, then swap pools
+static void compactTree(Mcts *m, int32_t node) {
+    MctsNode *src = m->pool, *dst = m->spare;
+    size_t next = 1;
+    dst[0] = src[node];
+    for (size_t q = 0; q < next; q++) {
+        if (dst[q].state != NODE_EXPANDED) {
+            dst[q].state = NODE_LEAF;
+            dst[q].firstChild = -1;
+            dst[q].childCount = 0;
+            continue;
+        }
+        memcpy(&dst[next], &src[dst[q].firstChild], dst[q].childCount * sizeof(MctsNode));
+        dst[q].firstChild = (int32_t)next;
+        next += dst[q].childCount;
+    }
+    m->spare = src;
+    m->pool = dst;
+    m->used = next;
+}
+
+// Follow the moves played since the last search down the old tree. Keeps
+// the subtree if every move is found, otherwise starts a fresh tree.
+static void advanceRoot(Mcts *m, const Board *b, int player, int players) {
+    Board walk = m->rootBoard;
+    int32_t node = 0;
+    int toMove = m->rootPlayer;
+
+    if (!m->rootValid || m->players != players || walk.size != b->size) {
+        m->players = players;
+        resetTree(m, b, player);
+        return;
+    }
+    while (walk.occupied != b->occupied) {
+        Bits added = b->pieces[toMove] & ~walk.pieces[toMove];
+        const MctsNode *n = &m->pool[node];
+        int32_t child = -1;
+        int cell;
+        if (bitsCount(added) != 1 || n->state != NODE_EXPANDED) break;
+        cell = bitCell(&walk, bitsFirst(added));
+        for (int i = 0; i < n->childCount; i++)
+            if (m->pool[n->firstChild + i].move == cell) child = n->firstChild + i;
+        if (child < 0) break;
+        boardPlace(&walk, cell, toMove);
+        node = child;
+        toMove = (toMove + 1) % players;
+    }
+    for (int p = 0; p < players; p++)
+        if (walk.pieces[p] != b->pieces[p]) toMove = -1;
+    if (toMove != player) {
+        resetTree(m, b, player);
+        return;
+    }
+    if (node != 0) compactTree(m, node);
+    m->rootBoard = *b;
+    m->rootPlayer = player;
+}
+
+// Give a leaf one child per empty cell. Only the thread that wins the
+// state change does the work; the others just play out from the leaf.
+static int expand(Mcts *m, MctsNode *n, const Board *b, int toMove) {
+    uint8_t expected = NODE_LEAF;
+    size_t base;
+    if (!__atomic_compare_exchange_n(&n->state, &expected, NODE_EXPANDING, 0,
+                                     __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        return 0;
+    base = __atomic_fetch_add(&m->used, (size_t)b->freeCount, __ATOMIC_RELAXED);
+    if (base + b->freeCount > m->config.maxNodes) {
+        // Pool is full: this node stays a leaf for good
+        __atomic_store_n(&n->state, NODE_LEAF, __ATOMIC_RELEASE);
+        return 0;
+    }
+    for (int i = 0; i < b->freeCount; i++) {
+        MctsNode *c = &m->pool[base + i];
+        c->firstChild = -1;
+        c->visits = 0;
+        c->score = 0;
+        c->move = b->freeCells[i];
+        c->player = (uint8_t)toMove;
+        c->childCount = 0;
+        c->state = NODE_LEAF;
+    }
+    n->firstChild = (int32_t)base;
+    n->childCount = (uint8_t)b->freeCount;
+    __atomic_store_n(&n->state, NODE_EXPANDED, __ATOMIC_RELEASE);
+    return 1;
+}
+
+// UCT from the point of view of the player choosing among the children.
+// Unvisited children come first, starting from a random one so threads
+// spread out.
+static int32_t selectChild(const Mcts *m, const MctsNode *n, uint64_t *rng) {
+    int32_t parentVisits = __atomic_load_n(&n->visits, __ATOMIC_RELAXED);
+    double logN = log(parentVisits > 1 ? parentVisits : 1);
+    double bestValue = -1;
+    int32_t best = n->firstChild;
+    int start = rngBelow(rng, n->childCount);
+    for (int k = 0; k < n->childCount; k++) {
+        int32_t i = n->firstChild + (start + k) % n->childCount;
+        int32_t visits = __atomic_load_n(&m->pool[i].visits, __ATOMIC_RELAXED);
+        int64_t score = __atomic_load_n(&m->pool[i].score, __ATOMIC_RELAXED);
+        double value;
+        if (visits == 0) return i;
+        value = (double)score / (POINT * visits)
+              + m->config.exploration * sqrt(logN / visits);
+        if (value > bestValue) {
+            bestValue = value;
+            best = i;
+        }
+    }
+    return best;
+}
+
+// Random moves to the end; returns the winner or -1 for a draw
+static int rollout(Board *b, int toMove, int players, uint64_t *rng) {
+    while (!boardIsDrawn(b)) {
+        int cell = b->freeCells[rngBelow(rng, b->freeCount)];
+        boardPlaceUnhashed(b, cell, toMove);
+        if (boardWinsAt(b, cell, toMove)) return toMove;
+        toMove = (toMove + 1) % players;
+    }
+    return -1;
+}
+
+static void playout(Mcts *m, uint64_t *rng) {
+    int32_t path[MAX_CELLS + 1];
+    int depth = 0, toMove = m->rootPlayer, winner = -2;
+    Board b = m->rootBoard;
+
+    path[0] = 0;
+    __atomic_fetch_add(&m->pool[0].visits, VIRTUAL_LOSS, __ATOMIC_RELAXED);
+    while (1) {
+        MctsNode *n = &m->pool[path[depth]];
+        int32_t child;
+        if (__atomic_load_n(&n->state, __ATOMIC_ACQUIRE) != NODE_EXPANDED) {
+            int visits = __atomic_load_n(&n->visits, __ATOMIC_RELAXED) - VIRTUAL_LOSS;
+            if ((depth > 0 && visits < EXPAND_AFTER) || !expand(m, n, &b, toMove))
+                break;
+        }
+        child = selectChild(m, n, rng);
+        __atomic_fetch_add(&m->pool[child].visits, VIRTUAL_LOSS, __ATOMIC_RELAXED);
+        path[++depth] = child;
+        boardPlaceUnhashed(&b, m->pool[child].move, toMove);
+        if (boardWinsAt(&b, m->pool[child].move, toMove)) {
+            winner = toMove;
+            break;
+        }
+        if (boardIsDrawn(&b)) {
+            winner = -1;
+            break;
+        }
+        toMove = (toMove + 1) % m->players;
+    }
+    if (winner == -2)
+        winner = rollout(&b, toMove, m->players, rng);
+
+    // Swap the virtual loss for the real result
+    for (int i = 0; i <= depth; i++) {
+        MctsNode *n = &m->pool[path[i]];
+        int64_t reward = (winner < 0) ? POINT / m->players : (n->player == winner) ? POINT : 0;
+        __atomic_fetch_add(&n->visits, 1 - VIRTUAL_LOSS, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&n->score, reward, __ATOMIC_RELAXED);
+    }
+}
+
+static void *workerMain(void *arg) {
+    MctsWorker *w = arg;
+    Mcts *m = w->m;
+    while (!__atomic_load_n(&m->stop, __ATOMIC_RELAXED)) {
+        if (m->cancel && __atomic_load_n(m->cancel, __ATOMIC_RELAXED)) break;
+        if (m->target) {
+            if (__atomic_fetch_add(&m->started, 1, __ATOMIC_RELAXED) >= m->target) break;
+        } else if ((w->playouts & 63) == 0 && nowSeconds() > m->deadline) {
+            __atomic_store_n(&m->stop, 1, __ATOMIC_RELAXED);
+            break;
+        }
+        playout(m, &w->rng);
+        w->playouts++;
+    }
+    return NULL;
+}
+
+// Search the position for player to move, with players taking turns in
+// order, and return the most visited move
+int mctsBestMove(Mcts *m, const Board *b, int player, int players, MctsResult *result) {
+    int threads = m->config.threads;
+    MctsWorker workers[threads];
+    pthread_t handles[threads];
+    int started = 0;
+    long long playouts = 0;
+    double start = nowSeconds();
+    const MctsNode *root;
+    int32_t best = -1;
+
+    advanceRoot(m, b, player, players);
+    m->target = m->config.iterations;
+    if (m->target == 0 && m->config.timeMs == 0) m->target = 10000;
+    m->started = 0;
+    m->stop = 0;
+    m->deadline = start + m->config.timeMs / 1000.0;
+
+    // Playouts a ponder already put under this root count toward the move
+    if (m->ponderRate > 0) {
+        const double credit = m->pool[0].visits;
+        if (m->target)
+            m->target -= (long long)fmin(credit, m->target * 0.9);
+        else
+            m->deadline -= fmin(credit / m->ponderRate, m->config.timeMs * 0.9 / 1000.0);
+        m->ponderRate = 0;
+    }
+
+    for (int i = 0; i < threads; i++) {
+        workers[i].m = m;
+        workers[i].rng = b->hashes[0] ^ ((uint64_t)(i + 1) * 0x9E3779B97F4A7C15ULL) ^ (uint64_t)m->used;
+        workers[i].playouts = 0;
+    }
+    for (int i = 1; i < threads; i++) {
+        if (pthread_create(&handles[i], NULL, workerMain, &workers[i]) != 0) break;
+        started = i;
+    }
+    workerMain(&workers[0]);
+    for (int i = 1; i <= started; i++)
+        pthread_join(handles[i], NULL);
+    for (int i = 0; i < threads; i++)
+        playouts += workers[i].playouts;
+
+    root = &m->pool[0];
+    for (int i = 0; root->state == NODE_EXPANDED && i < root->childCount; i++)
+        if (best < 0 || m->pool[root->firstChild + i].visits > m->pool[best].visits)
+            best = root->firstChild + i;
+
+    if (result) {
+        result->move = best >= 0 ? m->pool[best].move : b->freeCells[0];
+        result->playouts = playouts;
+        result->nodes = m->used < m->config.maxNodes ? m->used : m->config.maxNodes;
+        result->seconds = nowSeconds() - start;
+        result->winRate = (best >= 0 && m->pool[best].visits)
+                        ? (double)m->pool[best].score / (POINT * m->pool[best].visits) : 0;
+    }
+    return best >= 0 ? m->pool[best].move : b->freeCells[0];
+}
+
+// Grow the tree from player's turn until *stop turns nonzero, while
+// waiting for player to move. The next mctsBestMove keeps the subtree
+// under the move that was played and counts its playouts toward its own.
+void mctsPonder(Mcts *m, const Board *b, int player, int players, const int *stop) {
+    const MctsConfig config = m->config;
+    MctsResult result;
+    m->config.iterations = 0;
+    m->config.timeMs = INT_MAX;
+    m->cancel = stop;
+    m->ponderRate = 0;
+    mctsBestMove(m, b, player, players, &result);
+    m->cancel = NULL;
+    m->config = config;
+    m->ponderRate = result.seconds > 0 ? result.playouts / result.seconds : 0;
+}
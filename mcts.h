@@ -0,0 +1,63 @@
+#ifndef MCTS_H
+#define MCTS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "board.h"
+
+typedef struct {
+    int iterations;               // playouts per move, 0 to run until timeMs
+    int timeMs;                   // per-move budget when iterations is 0
+    int threads;                  // threads sharing the tree, 0 or 1 for one
+    size_t maxNodes;              // nodes in the pool
+    double exploration;           // UCT constant, 0 picks the default
+} MctsConfig;
+
+typedef struct {
+    int move;
+    long long playouts;
+    size_t nodes;                 // pool nodes in use after the search
+    double seconds;
+    double winRate;               // of the chosen move, for the mover
+} MctsResult;
+
+// One tree node. Children of a node sit next to each other in the pool,
+// so a node only needs the index of the first one and the count.
+typedef struct {
+    int32_t firstChild;
+    int32_t visits;               // includes virtual losses still in flight
+    int64_t score;                // sixths of a point, for the player who moved here
+    uint8_t move;
+    uint8_t player;               // who played move
+    uint8_t childCount;
+    uint8_t state;                // leaf, being expanded, or expanded
+} MctsNode;
+
+// UCT search over a shared tree. Nodes come from a fixed pool; between
+// turns the subtree under the moves actually played is copied to the
+// front of a second pool and the two are swapped, so the old tree's
+// memory is reclaimed without freeing anything.
+typedef struct {
+    MctsConfig config;
+    MctsNode *pool;
+    MctsNode *spare;
+    size_t used;
+    int players;                  // 2 or 3
+    Board rootBoard;              // position at pool[0]
+    int rootPlayer;               // player to move at the root
+    int rootValid;
+
+    long long target;             // playouts wanted this move
+    long long started;            // playouts handed out so far
+    double deadline;
+    int stop;
+    const int *cancel;            // while pondering: stop once it turns nonzero
+    double ponderRate;            // playouts per second of the last ponder, 0 if none since
+} Mcts;
+
+int  mctsInit(Mcts *m, const MctsConfig *config);
+void mctsFree(Mcts *m);
+int  mctsBestMove(Mcts *m, const Board *b, int player, int players, MctsResult *result);
+void mctsPonder(Mcts *m, const Board *b, int player, int players, const int *stop);
+
+#endif
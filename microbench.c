@@ -0,0 +1,324 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "board.h"
+#include "game.h"
+
+// Microbenchmarks for the primitives part03 is built on: win check, full
+// check, the random computer move, showing the board and logging it. Each
+// one runs on the same generated positions for every size from 3 to 10,
+// once per board representation in the impls table below, and reports
+// ns/op and heap allocations/op as CSV on stdout:
+//
+//   gcc -O2 -o microbench microbench.c game.c render.c movelog.c board.c rules.c -lpthread
+//   ./microbench > before.csv
+//
+// The "grid" representation is the original string grid part03 started
+// from, kept here as the reference. Another representation is compared by
+// adding a row to impls.
+
+#define POSITIONS 64        // positions per size, cycled through by every op
+#define MIN_SECONDS 0.05    // time each op for at least this long
+
+// Allocation counting: wrap glibc's allocator so anything an op mallocs,
+// directly or through stdio, shows up in its allocs/op
+extern void *__libc_malloc(size_t n);
+extern void *__libc_calloc(size_t count, size_t n);
+extern void *__libc_realloc(void *p, size_t n);
+static long long allocations;
+
+void *malloc(size_t n) {
+    allocations++;
+    return __libc_malloc(n);
+}
+
+void *calloc(size_t count, size_t n) {
+    allocations++;
+    return __libc_calloc(count, n);
+}
+
+void *realloc(void *p, size_t n) {
+    allocations++;
+    return __libc_realloc(p, n);
+}
+
+// A position as owners per cell (-1 empty), plus who moves next
+typedef struct {
+    signed char owner[MAX_CELLS];
+    int toMove;
+} Position;
+
+// One board representation. load sets up position p in the impl's own
+// state; the rest are the primitives being measured.
+typedef struct {
+    const char *name;
+    void (*load)(int p);
+    int  (*hasWon)(int player);
+    int  (*isFull)(void);
+    void (*move)(void);          // random computer move, then take it back
+    void (*show)(FILE *out);
+    void (*save)(FILE *out);
+} Impl;
+
+static Position positions[POSITIONS];
+static int boardSize;
+static volatile int sink;
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Random play from an empty board to a random length, stopping early at a
+// win, so the set mixes openings, middlegames, wins and full boards
+static void makePositions(int size, uint64_t seed) {
+    for (int p = 0; p < POSITIONS; p++) {
+        Board b;
+        int plies = rngBelow(&seed, size * size + 1), player = 0;
+        boardInit(&b, size);
+        for (int ply = 0; ply < plies; ply++) {
+            int cell = b.freeCells[rngBelow(&seed, b.freeCount)];
+            boardPlace(&b, cell, player);
+            player = (player + 1) % 2;
+            if (boardWinsAt(&b, cell, 1 - player)) break;
+        }
+        for (int cell = 0; cell < size * size; cell++)
+            positions[p].owner[cell] = (signed char)boardOwner(&b, cell);
+        positions[p].toMove = player;
+    }
+}
+
+// The original string grid: every cell holds its number until a symbol
+// replaces it, and every check compares strings
+
+static char grid[MAX_SIZE][MAX_SIZE][4];
+
+static void gridLoad(int p) {
+    for (int i = 0; i < boardSize; i++)
+        for (int j = 0; j < boardSize; j++) {
+            int owner = positions[p].owner[i * boardSize + j];
+            if (owner < 0)
+                sprintf(grid[i][j], "%d", i * boardSize + j);
+            else
+                sprintf(grid[i][j], "%c", playerSymbols[owner]);
+        }
+}
+
+static int gridHasWon(int playerIndex) {
+    char pStr[2] = {playerSymbols[playerIndex], '\0'};
+    int size = boardSize, winLength = (size >= 4) ? 4 : size;
+
+    for (int i = 0; i < size; i++)
+        for (int j = 0; j <= size - winLength; j++) {
+            int count = 0;
+            for (int k = 0; k < winLength; k++)
+                if (strcmp(grid[i][j + k], pStr) == 0) count++;
+            if (count == winLength) return 1;
+        }
+    for (int j = 0; j < size; j++)
+        for (int i = 0; i <= size - winLength; i++) {
+            int count = 0;
+            for (int k = 0; k < winLength; k++)
+                if (strcmp(grid[i + k][j], pStr) == 0) count++;
+            if (count == winLength) return 1;
+        }
+    for (int i = 0; i <= size - winLength; i++)
+        for (int j = 0; j <= size - winLength; j++) {
+            int count = 0;
+            for (int k = 0; k < winLength; k++)
+                if (strcmp(grid[i + k][j + k], pStr) == 0) count++;
+            if (count == winLength) return 1;
+        }
+    for (int i = 0; i <= size - winLength; i++)
+        for (int j = winLength - 1; j < size; j++) {
+            int count = 0;
+            for (int k = 0; k < winLength; k++)
+                if (strcmp(grid[i + k][j - k], pStr) == 0) count++;
+            if (count == winLength) return 1;
+        }
+    return 0;
+}
+
+static int gridIsFull(void) {
+    for (int i = 0; i < boardSize; i++)
+        for (int j = 0; j < boardSize; j++)
+            if (strcmp(grid[i][j], "X") != 0 &&
+                strcmp(grid[i][j], "O") != 0 &&
+                strcmp(grid[i][j], "Z") != 0)
+                return 0;
+    return 1;
+}
+
+static void gridMove(void) {
+    int move, row, col;
+    char moveStr[12];
+    if (gridIsFull()) return;
+    while (1) {
+        move = rand() % (boardSize * boardSize);
+        row = move / boardSize;
+        col = move % boardSize;
+        sprintf(moveStr, "%d", move);
+        if (strcmp(grid[row][col], moveStr) == 0) {
+            sprintf(grid[row][col], "%c", 'O');
+            break;
+        }
+    }
+    strcpy(grid[row][col], moveStr);
+}
+
+static void gridShow(FILE *out) {
+    fprintf(out, "\n");
+    for (int i = 0; i < boardSize; i++) {
+        fprintf(out, "   ");
+        for (int j = 0; j < boardSize; j++) {
+            fprintf(out, " %2s ", grid[i][j]);
+            if (j < boardSize - 1) fprintf(out, "|");
+        }
+        fprintf(out, "\n");
+        if (i < boardSize - 1) {
+            fprintf(out, "   ");
+            for (int k = 0; k < boardSize; k++) {
+                fprintf(out, "----");
+                if (k < boardSize - 1) fprintf(out, "+");
+            }
+            fprintf(out, "\n");
+        }
+    }
+    fprintf(out, "\n");
+}
+
+static void gridSave(FILE *out) {
+    for (int i = 0; i < boardSize; i++) {
+        for (int j = 0; j < boardSize; j++)
+            fprintf(out, "%s ", grid[i][j]);
+        fprintf(out, "\n");
+    }
+    fprintf(out, "---------------------\n");
+}
+
+// The bitboard Game that part03 plays on now
+
+static Game game;
+
+static void bitsLoad(int p) {
+    gameInit(&game, boardSize, 2, NULL);
+    for (int cell = 0; cell < boardSize * boardSize; cell++)
+        if (positions[p].owner[cell] >= 0)
+            boardPlace(&game.board, cell, positions[p].owner[cell]);
+    game.toMove = (unsigned char)positions[p].toMove;
+}
+
+// A full scan, like the grid's, with the rules compiled for the size;
+// gameHasWon itself only reads the result gamePlay already worked out
+// incrementally
+static int bitsHasWon(int player) {
+    return game.rules->hasWon(&game.board, player);
+}
+
+static int bitsIsFull(void) {
+    return gameIsFull(&game);
+}
+
+static void bitsMove(void) {
+    int cell;
+    if (gameIsFull(&game)) return;
+    cell = boardRandomFreeCell(&game.board);
+    boardPlace(&game.board, cell, 1);
+    boardRemove(&game.board, cell, 1);
+}
+
+static void bitsShow(FILE *out) {
+    gameShow(&game, out);
+}
+
+static void bitsSave(FILE *out) {
+    game.log = out;
+    gameSaveState(&game);
+    game.log = NULL;
+}
+
+static const Impl impls[] = {
+    {"grid", gridLoad, gridHasWon, gridIsFull, gridMove, gridShow, gridSave},
+    {"bitboard", bitsLoad, bitsHasWon, bitsIsFull, bitsMove, bitsShow, bitsSave},
+};
+
+enum { OP_HAS_WON, OP_IS_FULL, OP_MOVE, OP_SHOW, OP_SAVE, OP_COUNT };
+static const char *opNames[OP_COUNT] = {"hasWon", "isFull", "computerMove", "showBoard", "saveState"};
+
+// Each position is loaded once and the op repeated on it, so the load is
+// a small share of the run and can be timed separately and subtracted
+static int repeats(int op) {
+    return (op == OP_SHOW || op == OP_SAVE) ? 16 : 256;
+}
+
+static void runOp(const Impl *impl, int op, long long rounds, FILE *out) {
+    for (long long r = 0; r < rounds; r++) {
+        int p = (int)(r % POSITIONS);
+        impl->load(p);
+        for (int k = 0; k < repeats(op); k++) {
+            switch (op) {
+            case OP_HAS_WON: sink += impl->hasWon(k & 1); break;
+            case OP_IS_FULL: sink += impl->isFull(); break;
+            case OP_MOVE: impl->move(); break;
+            case OP_SHOW: impl->show(out); break;
+            case OP_SAVE: impl->save(out); break;
+            }
+        }
+    }
+}
+
+// Time only the loads, to subtract from the op timings
+static double loadSeconds(const Impl *impl, long long rounds) {
+    double start = nowSeconds();
+    for (long long r = 0; r < rounds; r++)
+        impl->load((int)(r % POSITIONS));
+    return nowSeconds() - start;
+}
+
+static void benchOp(const Impl *impl, int op, FILE *out) {
+    long long rounds = 64, before, ops;
+    double elapsed, start;
+    // Grow the run until it is long enough to time
+    while (1) {
+        start = nowSeconds();
+        runOp(impl, op, rounds, out);
+        elapsed = nowSeconds() - start;
+        if (elapsed >= MIN_SECONDS) break;
+        rounds *= 2;
+    }
+    before = allocations;
+    start = nowSeconds();
+    runOp(impl, op, rounds, out);
+    elapsed = nowSeconds() - start - loadSeconds(impl, rounds);
+    before = allocations - before;
+    ops = rounds * repeats(op);
+    if (elapsed < 0) elapsed = 0;
+    printf("%s,%d,%s,%lld,%.2f,%.4f\n", impl->name, boardSize, opNames[op], ops,
+           elapsed * 1e9 / ops, (double)before / ops);
+}
+
+int main(int argc, char *argv[]) {
+    int minSize = MIN_SIZE, maxSize = MAX_SIZE;
+    FILE *out = fopen("/dev/null", "w");
+    if (argc > 1) minSize = maxSize = atoi(argv[1]);
+    if (minSize < MIN_SIZE || maxSize > MAX_SIZE || !out) {
+        fprintf(stderr, "usage: %s [size]\n", argv[0]);
+        return 1;
+    }
+    srand(1);
+
+    printf("impl,size,op,ops,ns_per_op,allocs_per_op\n");
+    for (boardSize = minSize; boardSize <= maxSize; boardSize++) {
+        makePositions(boardSize, 0xB0A2D + (uint64_t)boardSize);
+        for (size_t i = 0; i < sizeof impls / sizeof impls[0]; i++)
+            for (int op = 0; op < OP_COUNT; op++)
+                benchOp(&impls[i], op, out);
+        fflush(stdout);
+    }
+    fclose(out);
+    return 0;
+}
@@ -0,0 +1,331 @@
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "movelog.h"
+
+#define MOVELOG_BUFFER (64 << 10)
+
+static int writeAll(FILE *file, const unsigned char *bytes, size_t length) {
+    return fwrite(bytes, 1, length, file) == length && fflush(file) == 0;
+}
+
+static void *writerMain(void *arg) {
+    MoveLog *log = arg;
+    pthread_mutex_lock(&log->lock);
+    while (1) {
+        unsigned char *batch, *indexBatch;
+        size_t length, indexLength;
+        while (log->pendingLength == 0 && !log->closing)
+            pthread_cond_wait(&log->wake, &log->lock);
+        if (log->pendingLength == 0) break;
+        batch = log->pending;
+        length = log->pendingLength;
+        indexBatch = log->pendingIndex;
+        indexLength = log->pendingIndexLength;
+        log->pending = log->writing;
+        log->writing = batch;
+        log->pendingIndex = log->writingIndex;
+        log->writingIndex = indexBatch;
+        log->pendingLength = log->pendingIndexLength = 0;
+        pthread_cond_broadcast(&log->drained);
+        pthread_mutex_unlock(&log->lock);
+
+        if (!log->failed && !writeAll(log->file, batch, length))
+            log->failed = 1;
+        if (!log->failed && log->index && indexLength && !writeAll(log->index, indexBatch, indexLength))
+            log->failed = 1;
+
+        pthread_mutex_lock(&log->lock);
+    }
+    pthread_mutex_unlock(&log->lock);
+    return NULL;
+}
+
+// Start appending to an open log file and, unless index is NULL, its
+// index. Returns 0 if the writer can't start.
+int moveLogOpen(MoveLog *log, FILE *file, FILE *index) {
+    memset(log, 0, sizeof *log);
+    log->file = file;
+    log->index = index;
+    log->capacity = MOVELOG_BUFFER;
+    // New games go after whatever earlier runs left
+    if (fseek(file, 0, SEEK_END) == 0) log->offset = (uint64_t)ftell(file);
+    if (index && fseek(index, 0, SEEK_END) == 0)
+        log->nextGame = (uint64_t)ftell(index) / MOVELOG_INDEX_ENTRY;
+    log->pending = malloc(log->capacity);
+    log->writing = malloc(log->capacity);
+    log->pendingIndex = malloc(log->capacity);
+    log->writingIndex = malloc(log->capacity);
+    pthread_mutex_init(&log->lock, NULL);
+    pthread_cond_init(&log->wake, NULL);
+    pthread_cond_init(&log->drained, NULL);
+    if (!log->pending || !log->writing || !log->pendingIndex || !log->writingIndex ||
+        pthread_create(&log->thread, NULL, writerMain, log) != 0) {
+        free(log->pending);
+        free(log->writing);
+        free(log->pendingIndex);
+        free(log->writingIndex);
+        return 0;
+    }
+    return 1;
+}
+
+// Queue bytes for the writer. It is only woken once a game ends or half
+// the buffer is used, so a game's moves go out in one write. Called with
+// the lock held.
+static void append(MoveLog *log, const unsigned char *bytes, size_t length, int flush) {
+    while (log->pendingLength + length > log->capacity)
+        pthread_cond_wait(&log->drained, &log->lock);
+    memcpy(log->pending + log->pendingLength, bytes, length);
+    log->pendingLength += length;
+    log->offset += length;
+    if (flush || log->pendingLength >= log->capacity / 2)
+        pthread_cond_signal(&log->wake);
+}
+
+static void appendEnd(MoveLog *log, int result) {
+    unsigned char end[2] = {MOVELOG_END, (unsigned char)result};
+    if (result == -2) end[1] = MOVELOG_DRAW;
+    else if (result < 0) end[1] = MOVELOG_QUIT;
+    log->inGame = 0;
+    append(log, end, sizeof end, 1);
+}
+
+// Start a game record; returns the game's id in the index
+uint64_t moveLogBegin(MoveLog *log, int size, int players, int firstPlayer) {
+    unsigned char header[MOVELOG_HEADER] = {'T', 'T', 'T', 'L', MOVELOG_VERSION};
+    uint64_t id;
+    header[5] = (unsigned char)size;
+    header[6] = (unsigned char)boardWinLength(size);
+    header[7] = (unsigned char)(players << 4 | firstPlayer);
+    pthread_mutex_lock(&log->lock);
+    if (log->inGame) appendEnd(log, -1);
+    // The header and its index entry go into the same batch
+    while (log->pendingLength + sizeof header > log->capacity ||
+           log->pendingIndexLength + MOVELOG_INDEX_ENTRY > log->capacity)
+        pthread_cond_wait(&log->drained, &log->lock);
+    for (int i = 0; i < MOVELOG_INDEX_ENTRY; i++)
+        log->pendingIndex[log->pendingIndexLength++] = (unsigned char)(log->offset >> (8 * i));
+    append(log, header, sizeof header, 0);
+    log->inGame = 1;
+    id = log->nextGame++;
+    pthread_mutex_unlock(&log->lock);
+    return id;
+}
+
+void moveLogMove(MoveLog *log, int cell) {
+    unsigned char byte = (unsigned char)cell;
+    pthread_mutex_lock(&log->lock);
+    append(log, &byte, 1, 0);
+    pthread_mutex_unlock(&log->lock);
+}
+
+void moveLogUndo(MoveLog *log) {
+    moveLogMove(log, MOVELOG_UNDO);
+}
+
+// result is the winner, -2 (GAME_DRAW) for a draw or -1 for a game that
+// was given up
+void moveLogEnd(MoveLog *log, int result) {
+    pthread_mutex_lock(&log->lock);
+    appendEnd(log, result);
+    pthread_mutex_unlock(&log->lock);
+}
+
+// Write out everything queued and stop the writer. Returns 0 if any
+// write failed. The files stay open.
+int moveLogClose(MoveLog *log) {
+    pthread_mutex_lock(&log->lock);
+    if (log->inGame) appendEnd(log, -1);
+    log->closing = 1;
+    pthread_cond_signal(&log->wake);
+    pthread_mutex_unlock(&log->lock);
+    pthread_join(log->thread, NULL);
+    pthread_mutex_destroy(&log->lock);
+    pthread_cond_destroy(&log->wake);
+    pthread_cond_destroy(&log->drained);
+    free(log->pending);
+    free(log->writing);
+    free(log->pendingIndex);
+    free(log->writingIndex);
+    return !log->failed;
+}
+
+static int parseHeader(const unsigned char *header, MoveLogGame *game) {
+    if (memcmp(header, "TTTL", 4) != 0 || header[4] != MOVELOG_VERSION) return 0;
+    game->size = header[5];
+    game->winLength = header[6];
+    game->players = header[7] >> 4;
+    game->firstPlayer = header[7] & 15;
+    game->moveCount = 0;
+    game->result = -1;
+    return game->size >= MIN_SIZE && game->size <= MAX_SIZE &&
+           game->players >= 2 && game->players <= MAX_PLAYERS &&
+           game->firstPlayer < game->players;
+}
+
+static int endResult(int code) {
+    return (code == MOVELOG_DRAW) ? -2 : (code == MOVELOG_QUIT) ? -1 : code;
+}
+
+// Read the next game. Returns 1 for a game, 0 at the end of the file and
+// -1 for a bad header. A game cut off by a crash comes back with
+// result -1 and the moves that made it to disk.
+int moveLogRead(FILE *in, MoveLogGame *game) {
+    unsigned char header[MOVELOG_HEADER];
+    int c;
+    size_t n = fread(header, 1, sizeof header, in);
+    if (n == 0) return 0;
+    if (n < sizeof header || !parseHeader(header, game)) return -1;
+    while ((c = fgetc(in)) != EOF) {
+        if (c == MOVELOG_END) {
+            c = fgetc(in);
+            if (c != EOF) game->result = endResult(c);
+            break;
+        }
+        if (c == MOVELOG_UNDO && game->moveCount > 0) {
+            game->moveCount--;
+            continue;
+        }
+        if (c >= game->size * game->size || game->moveCount == game->size * game->size)
+            return -1;
+        game->moves[game->moveCount++] = (unsigned char)c;
+    }
+    return 1;
+}
+
+// The same from memory: decodes the game at the start of data and
+// returns how many bytes it took, or -1 if it isn't a game
+long moveLogDecode(const unsigned char *data, size_t length, MoveLogGame *game) {
+    size_t at = MOVELOG_HEADER;
+    if (length < MOVELOG_HEADER || !parseHeader(data, game)) return -1;
+    while (at < length) {
+        int c = data[at++];
+        if (c == MOVELOG_END) {
+            if (at < length) game->result = endResult(data[at++]);
+            break;
+        }
+        if (c == MOVELOG_UNDO && game->moveCount > 0) {
+            game->moveCount--;
+            continue;
+        }
+        if (c >= game->size * game->size || game->moveCount == game->size * game->size)
+            return -1;
+        game->moves[game->moveCount++] = (unsigned char)c;
+    }
+    return (long)at;
+}
+
+// The position after the first ply moves of a game
+void moveLogReplay(const MoveLogGame *game, int ply, Board *b) {
+    boardInit(b, game->size);
+    if (ply > game->moveCount) ply = game->moveCount;
+    for (int i = 0; i < ply; i++)
+        boardPlace(b, game->moves[i], (game->firstPlayer + i) % game->players);
+}
+
+static const unsigned char *mapFile(const char *path, size_t *length) {
+    struct stat st;
+    void *data;
+    int fd = open(path, O_RDONLY);
+    *length = 0;
+    if (fd < 0) return NULL;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        close(fd);
+        return NULL;
+    }
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return NULL;
+    posix_madvise(data, (size_t)st.st_size, POSIX_MADV_WILLNEED);
+    *length = (size_t)st.st_size;
+    return data;
+}
+
+static uint64_t indexEntry(const unsigned char *entry) {
+    uint64_t offset = 0;
+    for (int i = MOVELOG_INDEX_ENTRY - 1; i >= 0; i--)
+        offset = offset << 8 | entry[i];
+    return offset;
+}
+
+uint64_t logViewOffset(const LogView *view, size_t id) {
+    if (id < view->indexed) return indexEntry(view->index + id * MOVELOG_INDEX_ENTRY);
+    return view->tail[id - view->indexed];
+}
+
+// Map a log and its index (indexPath may be NULL or missing). Index
+// entries are trusted while they point at game headers in order; any
+// games after the last good one are found by scanning. Returns 0 if the
+// log can't be mapped or there's no memory to list those games.
+int logViewOpen(LogView *view, const char *logPath, const char *indexPath) {
+    uint64_t at = 0;
+    size_t tailCap = 0;
+    MoveLogGame game;
+    memset(view, 0, sizeof *view);
+    view->data = mapFile(logPath, &view->length);
+    if (!view->data) return 0;
+    if (indexPath) view->index = mapFile(indexPath, &view->indexLength);
+
+    for (size_t n = view->indexLength / MOVELOG_INDEX_ENTRY; view->indexed < n; view->indexed++) {
+        uint64_t offset = indexEntry(view->index + view->indexed * MOVELOG_INDEX_ENTRY);
+        if (offset < at || offset + MOVELOG_HEADER > view->length ||
+            memcmp(view->data + offset, "TTTL", 4) != 0)
+            break;
+        at = offset;
+    }
+    if (view->indexed > 0) {
+        long used = moveLogDecode(view->data + at, view->length - at, &game);
+        at += used > 0 ? (uint64_t)used : view->length - at;
+    }
+    while (at < view->length) {
+        long used = moveLogDecode(view->data + at, view->length - at, &game);
+        if (used < 0) break;
+        if (view->games == tailCap) {
+            uint64_t *grown;
+            tailCap = tailCap ? tailCap * 2 : 1024;
+            if (!(grown = realloc(view->tail, tailCap * sizeof *grown))) {
+                logViewClose(view);
+                return 0;
+            }
+            view->tail = grown;
+        }
+        view->tail[view->games++] = at;
+        at += (uint64_t)used;
+    }
+    view->games += view->indexed;
+    return 1;
+}
+
+void logViewClose(LogView *view) {
+    if (view->data) munmap((void *)view->data, view->length);
+    if (view->index) munmap((void *)view->index, view->indexLength);
+    free(view->tail);
+    memset(view, 0, sizeof *view);
+}
+
+// Decode game id, stopping at the next game's offset so a game cut short
+// by a crash never runs into the one after it
+int logViewGame(const LogView *view, size_t id, MoveLogGame *game) {
+    uint64_t start, end;
+    if (id >= view->games) return 0;
+    start = logViewOffset(view, id);
+    end = (id + 1 < view->games) ? logViewOffset(view, id + 1) : view->length;
+    return moveLogDecode(view->data + start, end - start, game) > 0;
+}
+
+// Write a fresh index covering every game in the view
+int logViewWriteIndex(const LogView *view, FILE *out) {
+    for (size_t id = 0; id < view->games; id++) {
+        unsigned char entry[MOVELOG_INDEX_ENTRY];
+        uint64_t offset = logViewOffset(view, id);
+        for (int i = 0; i < MOVELOG_INDEX_ENTRY; i++)
+            entry[i] = (unsigned char)(offset >> (8 * i));
+        if (fwrite(entry, 1, sizeof entry, out) != sizeof entry) return 0;
+    }
+    return fflush(out) == 0;
+}
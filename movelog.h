@@ -0,0 +1,95 @@
+#ifndef MOVELOG_H
+#define MOVELOG_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "board.h"
+
+// Binary game log. Each game is an 8-byte header, one byte per move (the
+// cell) and a 2-byte end record:
+//
+//   'T' 'T' 'T' 'L' version size winLength players<<4|firstPlayer
+//   cell cell cell ...
+//   MOVELOG_END result            the winner, MOVELOG_DRAW or MOVELOG_QUIT
+//
+// A MOVELOG_UNDO byte among the cells takes back the move before it.
+// Whose move each cell was follows from firstPlayer and the turn order,
+// so a game costs one byte per move or take-back plus the 8-byte header
+// and 2-byte end record, instead of a text board per move.
+// Logs are only ever appended to. The index next to a log holds one
+// 8-byte little-endian file offset per game, so game n starts at entry n.
+
+#define MOVELOG_VERSION 1
+#define MOVELOG_END 0xFF
+#define MOVELOG_DRAW 0xFE
+#define MOVELOG_QUIT 0xFD       // abandoned before it finished
+#define MOVELOG_UNDO 0xFC
+#define MOVELOG_HEADER 8
+#define MOVELOG_INDEX_ENTRY 8
+
+// Records are copied into pending buffers under a lock; a writer thread
+// swaps them out and writes them, so the game loop never waits on the
+// files unless it gets a whole buffer ahead of the disk. The log is
+// written before the index, so an index entry never points past the end
+// of the log.
+typedef struct {
+    FILE *file;
+    FILE *index;                  // NULL for none
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;          // data to write, or closing
+    pthread_cond_t drained;       // pending has room again
+    unsigned char *pending, *writing;
+    unsigned char *pendingIndex, *writingIndex;
+    size_t pendingLength, pendingIndexLength;
+    size_t capacity;
+    uint64_t offset;              // file offset the next record lands at
+    uint64_t nextGame;            // id the next game gets
+    int closing;
+    int inGame;                   // a header went out without its end record
+    int failed;                   // a write failed; later records are dropped
+} MoveLog;
+
+// One game read back from a log
+typedef struct {
+    int size;
+    int winLength;
+    int players;
+    int firstPlayer;
+    int moveCount;
+    unsigned char moves[MAX_CELLS];   // with any taken back already removed
+    int result;                   // winner, -2 for a draw, -1 if abandoned or cut short
+} MoveLogGame;
+
+// A log and its index mapped read-only, for random access to any game.
+// Games past the end of the index (after a crash, or with no index at
+// all) are found by scanning and kept in tail.
+typedef struct {
+    const unsigned char *data;
+    size_t length;
+    const unsigned char *index;
+    size_t indexLength;
+    size_t indexed;               // games covered by the index
+    uint64_t *tail;               // offsets of the games after those
+    size_t games;
+} LogView;
+
+int      moveLogOpen(MoveLog *log, FILE *file, FILE *index);
+uint64_t moveLogBegin(MoveLog *log, int size, int players, int firstPlayer);
+void     moveLogMove(MoveLog *log, int cell);
+void     moveLogUndo(MoveLog *log);
+void     moveLogEnd(MoveLog *log, int result);
+int      moveLogClose(MoveLog *log);
+
+int  moveLogRead(FILE *in, MoveLogGame *game);
+long moveLogDecode(const unsigned char *data, size_t length, MoveLogGame *game);
+void moveLogReplay(const MoveLogGame *game, int ply, Board *b);
+
+int      logViewOpen(LogView *view, const char *logPath, const char *indexPath);
+void     logViewClose(LogView *view);
+uint64_t logViewOffset(const LogView *view, size_t id);
+int      logViewGame(const LogView *view, size_t id, MoveLogGame *game);
+int      logViewWriteIndex(const LogView *view, FILE *out);
+
+#endif
@@ -0,0 +1,337 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "multi.h"
+#include "pattern.h"
+#include "tt.h"
+
+#define INF (MULTI_WIN + 1)
+#define WIN_BOUND (MULTI_WIN - MAX_CELLS)   // anything above is a forced win
+#define NO_MOVE 0xFF
+
+static const uint64_t sideKeys[MAX_PLAYERS] = {
+    0, 0xD1B54A32D192ED03ULL, 0x8CB92BA72F3D8DD7ULL,
+};
+// Paranoid scores are the root player's, so the root is part of the key
+static const uint64_t rootKeys[MAX_PLAYERS] = {
+    0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL, 0x510E527FADE682D1ULL,
+};
+
+int multiInit(MultiSearch *s, const MultiConfig *config) {
+    size_t buckets = 1;
+    memset(s, 0, sizeof *s);
+    s->config = *config;
+    while (buckets * 2 * 2 * sizeof(MultiEntry) <= config->ttBytes)
+        buckets *= 2;
+    s->table = calloc(buckets * 2, sizeof(MultiEntry));
+    s->buckets = s->table ? buckets : 0;
+    return s->table != NULL;
+}
+
+void multiFree(MultiSearch *s) {
+    free(s->table);
+    s->table = NULL;
+    s->buckets = 0;
+}
+
+// Three players make the tree much wider per round of moves
+int multiDefaultDepth(int size) {
+    if (size == 3) return 9;
+    if (size == 4) return 6;
+    return 4;
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Wins are stored relative to the node so they stay valid at any ply
+static int toTT(int score, int ply) {
+    if (score > WIN_BOUND) return score + ply;
+    if (score < -WIN_BOUND) return score - ply;
+    return score;
+}
+
+static int fromTT(int score, int ply) {
+    if (score > WIN_BOUND) return score - ply;
+    if (score < -WIN_BOUND) return score + ply;
+    return score;
+}
+
+static const MultiEntry *probe(const MultiSearch *s, uint64_t key) {
+    const MultiEntry *bucket = &s->table[(key & (s->buckets - 1)) * 2];
+    for (int i = 0; i < 2; i++)
+        if (bucket[i].depth && bucket[i].key == key) return &bucket[i];
+    return NULL;
+}
+
+// Slot 0 keeps the deepest result for the bucket, slot 1 the newest
+static void store(MultiSearch *s, uint64_t key, const int *scores, int ply, int depth, int bound, int move) {
+    MultiEntry *bucket = &s->table[(key & (s->buckets - 1)) * 2], *e = &bucket[1];
+    if (bucket[0].key == key || bucket[0].depth == 0 || depth + 1 >= bucket[0].depth) {
+        if (bucket[0].key != key && bucket[0].depth) bucket[1] = bucket[0];
+        e = &bucket[0];
+    }
+    e->key = key;
+    for (int p = 0; p < MAX_PLAYERS; p++)
+        e->scores[p] = (int16_t)toTT(scores[p], ply);
+    e->depth = (uint8_t)(depth + 1);
+    e->bound = (uint8_t)bound;
+    e->move = (uint8_t)move;
+}
+
+static int nextPlayer(const MultiSearch *s, int player) {
+    return player + 1 == s->players ? 0 : player + 1;
+}
+
+// Candidate moves, best guess first: the table's move, then by history.
+// When the next player could win on their move, only the cells that stop
+// it are worth trying. Returns how many.
+static int orderMoves(const MultiSearch *s, const Board *b, int toMove, int ttMove, int *moves) {
+    int keys[MAX_CELLS], n = 0;
+    Bits cand = s->rules->threats(b, nextPlayer(s, toMove));
+    if (!cand) cand = boardCandidates(b);
+    if (b->occupied == 0)
+        cand = cellMask(b, (b->size / 2) * b->size + b->size / 2);
+    while (cand) {
+        int cell = bitCell(b, bitsFirst(cand));
+        int key = (cell == ttMove) ? 1 << 30 : s->history[toMove][cell];
+        int i = n++;
+        cand &= cand - 1;
+        while (i > 0 && keys[i - 1] < key) {
+            keys[i] = keys[i - 1];
+            moves[i] = moves[i - 1];
+            i--;
+        }
+        keys[i] = key;
+        moves[i] = cell;
+    }
+    return n;
+}
+
+// Time and the ponder's stop flag are only looked at every 1024 nodes
+static int outOfTime(MultiSearch *s) {
+    if ((++s->nodes & 1023) == 0 &&
+        ((s->deadline > 0 && nowSeconds() > s->deadline) ||
+         (s->stop && __atomic_load_n(s->stop, __ATOMIC_RELAXED))))
+        s->stopped = 1;
+    return s->stopped;
+}
+
+static void winFor(const MultiSearch *s, int winner, int ply, int *scores) {
+    for (int p = 0; p < s->players; p++)
+        scores[p] = (p == winner) ? MULTI_WIN - ply : 0;
+}
+
+// Max^n leaf: MULTI_SHARE split in proportion to each player's open
+// windows, so the scores always add up to at most MULTI_WIN
+static void evaluateAll(const MultiSearch *s, const Board *b, int *scores) {
+    int raw[MAX_PLAYERS], total = 0;
+    Patterns p;
+    patternCount(b, s->players, &p);
+    for (int q = 0; q < s->players; q++) {
+        raw[q] = 1 + patternValue(&p, q);
+        total += raw[q];
+    }
+    for (int q = 0; q < s->players; q++)
+        scores[q] = (int)((long long)MULTI_SHARE * raw[q] / total);
+}
+
+// Every player's score with toMove to play. parentBest is what the
+// player who moved into this node is already sure of elsewhere: once
+// toMove is sure of more than MULTI_WIN - parentBest, that player can't
+// get more here than they already have, so the rest is skipped.
+static void maxn(MultiSearch *s, Board *b, int depth, int ply, int toMove, int parentBest, int *scores) {
+    int moves[MAX_CELLS], n, child[MAX_PLAYERS], bestMove = -1, ttMove = -1;
+    int bound = TT_EXACT;
+    uint64_t key;
+    const int symmetry = boardCanonical(b, &key);
+    const MultiEntry *hit;
+    key ^= sideKeys[toMove];
+
+    if (outOfTime(s)) return;
+    if ((hit = probe(s, key)) != NULL) {
+        if (hit->move != NO_MOVE)
+            ttMove = symmetryCell(b->size, symmetryInverse[symmetry], hit->move);
+        if (hit->depth > depth && hit->bound == TT_EXACT && ply > 0) {
+            for (int p = 0; p < s->players; p++)
+                scores[p] = fromTT(hit->scores[p], ply);
+            return;
+        }
+    }
+    if (s->rules->threats(b, toMove)) {
+        winFor(s, toMove, ply + 1, scores);
+        return;
+    }
+    if (depth == 0) {
+        evaluateAll(s, b, scores);
+        return;
+    }
+
+    scores[toMove] = -1;
+    n = orderMoves(s, b, toMove, ttMove, moves);
+    for (int i = 0; i < n; i++) {
+        boardPlace(b, moves[i], toMove);
+        if (boardIsDrawn(b)) {
+            for (int p = 0; p < s->players; p++)
+                child[p] = MULTI_SHARE / s->players;
+        } else
+            maxn(s, b, depth - 1, ply + 1, nextPlayer(s, toMove), scores[toMove], child);
+        boardRemove(b, moves[i], toMove);
+        if (s->stopped) return;
+
+        if (child[toMove] > scores[toMove]) {
+            memcpy(scores, child, sizeof child);
+            bestMove = moves[i];
+        }
+        if (scores[toMove] >= MULTI_WIN - parentBest && i + 1 < n) {
+            s->history[toMove][moves[i]] += depth * depth;
+            bound = TT_LOWER;
+            break;
+        }
+    }
+    if (ply == 0) s->rootMove = bestMove;
+    store(s, key, scores, ply, depth, bound,
+          bestMove < 0 ? NO_MOVE : symmetryCell(b->size, symmetry, bestMove));
+}
+
+// The root player's score with toMove to play, everyone else against it
+static int paranoid(MultiSearch *s, Board *b, int depth, int ply, int toMove, int alpha, int beta) {
+    const int maximizing = toMove == s->root;
+    const int alphaOrig = alpha, betaOrig = beta;
+    int moves[MAX_CELLS], n, best = maximizing ? -INF : INF, bestMove = -1, ttMove = -1;
+    int scores[MAX_PLAYERS] = {0};
+    uint64_t key;
+    const int symmetry = boardCanonical(b, &key);
+    const MultiEntry *hit;
+    key ^= sideKeys[toMove] ^ rootKeys[s->root];
+
+    if (outOfTime(s)) return 0;
+    if ((hit = probe(s, key)) != NULL) {
+        if (hit->move != NO_MOVE)
+            ttMove = symmetryCell(b->size, symmetryInverse[symmetry], hit->move);
+        if (hit->depth > depth && ply > 0) {
+            int score = fromTT(hit->scores[0], ply);
+            if (hit->bound == TT_EXACT ||
+                (hit->bound == TT_LOWER && score >= beta) ||
+                (hit->bound == TT_UPPER && score <= alpha))
+                return score;
+        }
+    }
+    if (s->rules->threats(b, toMove))
+        return maximizing ? MULTI_WIN - ply - 1 : -(MULTI_WIN - ply - 1);
+    if (depth == 0) {
+        Patterns p;
+        int score;
+        patternCount(b, s->players, &p);
+        score = patternScore(&p, s->root, s->players);
+        return score > WIN_BOUND - 1 ? WIN_BOUND - 1 : score < 1 - WIN_BOUND ? 1 - WIN_BOUND : score;
+    }
+
+    n = orderMoves(s, b, toMove, ttMove, moves);
+    for (int i = 0; i < n; i++) {
+        int score;
+        boardPlace(b, moves[i], toMove);
+        score = boardIsDrawn(b) ? 0 : paranoid(s, b, depth - 1, ply + 1, nextPlayer(s, toMove), alpha, beta);
+        boardRemove(b, moves[i], toMove);
+        if (s->stopped) return 0;
+
+        if (maximizing ? score > best : score < best) {
+            best = score;
+            bestMove = moves[i];
+        }
+        if (maximizing && score > alpha) alpha = score;
+        if (!maximizing && score < beta) beta = score;
+        if (alpha >= beta) {
+            s->history[toMove][moves[i]] += depth * depth;
+            break;
+        }
+    }
+    if (ply == 0) s->rootMove = bestMove;
+    scores[0] = best;
+    store(s, key, scores, ply, depth,
+          best <= alphaOrig ? TT_UPPER : best >= betaOrig ? TT_LOWER : TT_EXACT,
+          bestMove < 0 ? NO_MOVE : symmetryCell(b->size, symmetry, bestMove));
+    return best;
+}
+
+// Iterative deepening from toMove's turn on behalf of root, who is also
+// the one to move unless this is a ponder
+static int deepen(MultiSearch *s, Board *b, int toMove, int players, int root, MultiResult *result) {
+    int limit = s->config.maxDepth;
+    int move = b->freeCells[0], score = 0, completed = 0;
+    double start = nowSeconds();
+    Bits wins;
+
+    s->rules = rulesFor(b->size);
+    s->players = players;
+    s->root = root;
+    s->nodes = 0;
+    s->stopped = 0;
+    s->deadline = 0;
+
+    // A win on the spot needs no search
+    wins = s->rules->threats(b, toMove);
+    if (wins) {
+        move = bitCell(b, bitsFirst(wins));
+        score = MULTI_WIN - 1;
+        completed = 1;
+        limit = 0;
+    } else if (limit == 0)
+        limit = s->config.timeMs ? b->freeCount : multiDefaultDepth(b->size);
+    if (limit > b->freeCount) limit = b->freeCount;
+
+    for (int depth = 1; depth <= limit; depth++) {
+        int scores[MAX_PLAYERS], value;
+        s->rootMove = -1;
+        if (s->config.mode == MULTI_PARANOID)
+            value = paranoid(s, b, depth, 0, toMove, -INF, INF);
+        else {
+            maxn(s, b, depth, 0, toMove, 0, scores);
+            value = scores[toMove];
+        }
+        if (s->stopped) break;
+
+        score = value;
+        completed = depth;
+        if (s->rootMove >= 0) move = s->rootMove;
+
+        // The clock only starts once depth 1 is in, so there is always a move
+        if (depth == 1 && s->config.timeMs)
+            s->deadline = start + s->config.timeMs / 1000.0;
+        if (score > WIN_BOUND || score < -WIN_BOUND) break;
+    }
+
+    if (result) {
+        result->move = move;
+        result->score = score;
+        result->depth = completed;
+        result->nodes = s->nodes;
+    }
+    return move;
+}
+
+// Search the position for player to move and return the chosen cell.
+// With a time budget the answer is the best move of the deepest
+// iteration that finished. The board is left exactly as it was passed in.
+int multiBestMove(MultiSearch *s, Board *b, int player, int players, MultiResult *result) {
+    return deepen(s, b, player, players, player, result);
+}
+
+// Search from toMove's turn on forPlayer's behalf until *stop turns
+// nonzero, with no depth or time limit of its own. Used while waiting for
+// toMove: forPlayer's search that follows finds most of its tree in the
+// table. Paranoid entries are keyed on the player searched for, hence
+// forPlayer rather than toMove.
+void multiPonder(MultiSearch *s, Board *b, int toMove, int players, int forPlayer, const int *stop) {
+    const MultiConfig config = s->config;
+    s->config.maxDepth = MAX_CELLS;
+    s->config.timeMs = 0;
+    s->stop = stop;
+    deepen(s, b, toMove, players, forPlayer, NULL);
+    s->stop = NULL;
+    s->config = config;
+}
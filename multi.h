@@ -0,0 +1,72 @@
+#ifndef MULTI_H
+#define MULTI_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "board.h"
+#include "rules.h"
+
+#define MULTI_WIN 30000           // the winner's score for a win on the next move
+#define MULTI_SHARE 9000          // what the other outcomes split between the players
+
+// How the other players are assumed to play
+enum {
+    MULTI_MAXN,                   // each for themselves: scores are per player
+    MULTI_PARANOID,               // all against the mover: alpha-beta applies
+};
+
+typedef struct {
+    int mode;                     // MULTI_MAXN or MULTI_PARANOID
+    int maxDepth;                 // plies to look ahead, 0 picks one from the board size
+    size_t ttBytes;               // transposition table budget
+    int timeMs;                   // per-move wall-clock budget, 0 for none
+} MultiConfig;
+
+typedef struct {
+    int move;
+    int score;                    // max^n: the mover's own; paranoid: the mover's against the rest
+    int depth;                    // last depth that finished
+    long long nodes;
+} MultiResult;
+
+// One table entry. Max^n keeps every player's score; paranoid only needs
+// the root player's, in scores[0].
+typedef struct {
+    uint64_t key;
+    int16_t scores[MAX_PLAYERS];
+    uint8_t depth;                // depth + 1, 0 for an empty slot
+    uint8_t bound;                // TT_EXACT, TT_LOWER or TT_UPPER
+    uint8_t move;                 // canonical orientation, 255 for none
+} MultiEntry;
+
+// Search for games of two or three players, deepened one ply at a time
+// until the depth limit or the time budget runs out. Max^n backs up a
+// score for every player and prunes only when the scores' fixed total
+// says the player above can't want this branch (shallow pruning).
+// Paranoid has everyone else minimise the mover's score, which turns it
+// into two sides and gets full alpha-beta. Both only try cells next to
+// pieces, answer a win on the next move with a block, and share a table
+// keyed on the canonical position and the side to move that carries over
+// from one move to the next.
+typedef struct {
+    MultiConfig config;
+    MultiEntry *table;
+    size_t buckets;               // power of two, two entries each
+    const Rules *rules;           // for the board being searched
+    int players;
+    int root;                     // the player the search is for
+    int rootMove;
+    long long nodes;
+    int history[MAX_PLAYERS][MAX_CELLS];
+    double deadline;              // seconds on the monotonic clock
+    int stopped;                  // ran out of time mid-iteration
+    const int *stop;              // while pondering: stop once it turns nonzero
+} MultiSearch;
+
+int  multiInit(MultiSearch *s, const MultiConfig *config);
+void multiFree(MultiSearch *s);
+int  multiDefaultDepth(int size);
+int  multiBestMove(MultiSearch *s, Board *b, int player, int players, MultiResult *result);
+void multiPonder(MultiSearch *s, Board *b, int toMove, int players, int forPlayer, const int *stop);
+
+#endif
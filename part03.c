@@ -1,29 +1,151 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
 #include <stdio.h>
-#include <string.h>
-#include <ctype.h>
 #include <stdlib.h>
+#include <string.h>
 #include <time.h>
-
-#define MAX_SIZE 10
-#define MIN_SIZE 3
-
-char board[MAX_SIZE][MAX_SIZE][4];
-FILE *logFile;
+#include <unistd.h>
+#include "game.h"
+#include "render.h"
+#include "search.h"
+#include "mcts.h"
+#include "multi.h"
+#include "perfect.h"
+
+enum { AI_AUTO, AI_SEARCH, AI_MCTS, AI_RANDOM, AI_MAXN, AI_PARANOID };
+
+// A scripted game's unread moves, and what went wrong with them
+typedef struct {
+    char *next;                 // rest of the script line
+    int line;
+} Script;
+
+typedef struct {
+    int line;
+    int ply;                    // moves played before the bad one
+    int result;                 // MOVE_OUT_OF_RANGE, MOVE_TAKEN, -1 for not a number
+                                // or -2 for u/r with nothing to undo or redo
+    char text[12];
+} ScriptError;
+
+// While a human is thinking, the computer who moves next searches on a
+// thread of its own, so its table or tree is already filled in when the
+// move comes
+typedef struct {
+    pthread_t thread;
+    int running;
+    int stop;                   // set as soon as the human's input is read
+    Board board;                // the ponder's own copy of the position
+    int toMove, players, computer;
+    struct timespec started;
+    double seconds;             // spent on this position, off the computer's next budget
+} Ponder;
+
+// The computer players keep their tables and trees from move to move
+Search engine;
+Mcts treeSearch;
+MultiSearch multiSearch;
+int requestedAi = AI_AUTO;
+int computerAi = AI_AUTO;       // what this game uses
+int searchReady = 0, mctsReady = 0, multiReady = 0;
+SearchConfig searchConfig = {0, 16 << 20, 0, 1};
+MctsConfig mctsConfig = {20000, 0, 1, (16 << 20) / (2 * sizeof(MctsNode)), 0};
+MultiConfig multiConfig = {MULTI_PARANOID, 0, 16 << 20, 0};
+PerfectTable perfect4;          // from perfect4.tbl, if solve has written one
+Renderer screen;
+MoveLog moveLog;
+int textLog = 0;
+int scripted = 0;
+ScriptError *scriptErrors;
+int scriptErrorCount = 0, scriptErrorCap = 0;
+int scriptErrorsUnlisted = 0;    // bad moves there was no memory to list
+Ponder ponder;
 
 // Function prototypes
-void setupBoard(int size);
-void showBoard(int size);
-void saveBoardState(int size);
-void promptPlayerMove(int size, char player);
-void computerMove(int size, char computerSymbol);
-int hasPlayerWon(int size, char player);
-int isBoardFull(int size);
-
-int main() {
+int setupComputer(int size, int mode);
+int playGame(Game *game, int mode, const int isComputer[], Script *script);
+int runScript(FILE *in, FILE *logFile);
+void showBoard(const Game *game);
+int promptPlayerMove(Game *game, const int isComputer[]);
+int scriptedPlayerMove(Game *game, const int isComputer[], Script *script);
+int undoMove(Game *game, const int isComputer[]);
+int redoMove(Game *game, const int isComputer[]);
+int computerMove(Game *game);
+void startPondering(const Game *game, const int isComputer[]);
+void stopPondering(void);
+void *ponderMain(void *arg);
+int ponderedBudget(int timeMs);
+
+int main(int argc, char *argv[]) {
     int size, mode;
-    char symbols[3] = {'X','O','Z'};
     int isComputer[3] = {0,0,0}; // 0 human, 1 computer
-    int currentPlayerIndex = 0;
+    Game game;
+    FILE *logFile, *indexFile = NULL, *script = NULL;
+
+    // Optional computer settings:
+    // -a <search|mcts|random|maxn|paranoid> -d <plies> -m <memory MB> -t <ms per move>
+    // -j <threads> -i <mcts playouts per move> -r <full|diff> board redraws
+    // -l <binary|text> append to game_log.bin (read with logreplay) or game_log.txt
+    // -s <file or -> play the games in a script instead of asking
+    for (int i = 1; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "-a") == 0) {
+            if (strcmp(argv[i + 1], "search") == 0) requestedAi = AI_SEARCH;
+            else if (strcmp(argv[i + 1], "mcts") == 0) requestedAi = AI_MCTS;
+            else if (strcmp(argv[i + 1], "random") == 0) requestedAi = AI_RANDOM;
+            else if (strcmp(argv[i + 1], "maxn") == 0) requestedAi = AI_MAXN;
+            else if (strcmp(argv[i + 1], "paranoid") == 0) requestedAi = AI_PARANOID;
+        }
+        else if (strcmp(argv[i], "-d") == 0)
+            searchConfig.maxDepth = multiConfig.maxDepth = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-m") == 0) {
+            searchConfig.ttBytes = multiConfig.ttBytes = (size_t)atoi(argv[i + 1]) << 20;
+            mctsConfig.maxNodes = searchConfig.ttBytes / (2 * sizeof(MctsNode));
+        }
+        else if (strcmp(argv[i], "-t") == 0) {
+            searchConfig.timeMs = multiConfig.timeMs = atoi(argv[i + 1]);
+            mctsConfig.timeMs = atoi(argv[i + 1]);
+            mctsConfig.iterations = 0;
+        }
+        else if (strcmp(argv[i], "-j") == 0) {
+            searchConfig.threads = atoi(argv[i + 1]);
+            mctsConfig.threads = atoi(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "-i") == 0)
+            mctsConfig.iterations = atoi(argv[i + 1]);
+        else if (strcmp(argv[i], "-r") == 0)
+            screen.mode = strcmp(argv[i + 1], "diff") == 0 ? RENDER_DIFF : RENDER_FULL;
+        else if (strcmp(argv[i], "-l") == 0)
+            textLog = strcmp(argv[i + 1], "text") == 0;
+        else if (strcmp(argv[i], "-s") == 0) {
+            script = strcmp(argv[i + 1], "-") == 0 ? stdin : fopen(argv[i + 1], "r");
+            if (!script) {
+                printf("Couldn't open the script %s. Exiting.\n", argv[i + 1]);
+                return 1;
+            }
+            scripted = 1;
+        }
+    }
+    rendererInit(&screen, STDOUT_FILENO, screen.mode);
+    perfectLoad(&perfect4, "perfect4.tbl");
+    srand(time(NULL));
+
+    // Games are appended, so earlier runs stay in the log
+    logFile = textLog ? fopen("game_log.txt", "a") : fopen("game_log.bin", "ab");
+    if (!textLog) indexFile = fopen("game_log.idx", "ab");
+    if (!logFile || (!textLog && (!indexFile || !moveLogOpen(&moveLog, logFile, indexFile)))) {
+        printf("Couldn't open log file. Exiting.\n");
+        return 1;
+    }
+    if (scripted) {
+        int status = runScript(script, logFile);
+        if (script != stdin) fclose(script);
+        if (!textLog) {
+            moveLogClose(&moveLog);
+            fclose(indexFile);
+        }
+        fclose(logFile);
+        return status;
+    }
 
     printf("Welcome to Tic Tac Toe!\n");
     printf("Choose your board size (%d to %d): ", MIN_SIZE, MAX_SIZE);
@@ -44,20 +166,19 @@ int main() {
         return 1;
     }
 
-    setupBoard(size);
+    if (!setupComputer(size, mode))
+        return 1;
 
     if (size >= 4)
         printf("Note: You only need to align 4 symbols in a row, column, or diagonal to win.\n");
+    printf("Type u instead of a cell to take back a move, r to play it again.\n");
 
-    logFile = fopen("game_log.txt", "w");
-    if (!logFile) {
-        printf("Couldn't open log file. Exiting.\n");
-        return 1;
-    }
-
-    srand(time(NULL));
+    gameInit(&game, size, (mode == 3) ? 3 : 2, textLog ? logFile : NULL);
+    if (!textLog) game.moveLog = &moveLog;
 
     // Configure multi-player roles
+    if (mode == 2)
+        isComputer[1] = 1;
     if (mode == 3) {
         char ans;
         printf("Player X is always human.\n");
@@ -70,220 +191,358 @@ int main() {
         isComputer[2] = (ans == 'y' || ans == 'Y') ? 1 : 0;
     }
 
-    while (1) {
-        showBoard(size);
-
-        if (mode == 1) {                                    // Player vs Player
-            char player = (currentPlayerIndex==0)?'X':'O';
-            promptPlayerMove(size, player);
-
-            saveBoardState(size);
-            if (hasPlayerWon(size, player)) {
-                showBoard(size);
-                printf("Player %c wins!\n", player);
-                fprintf(logFile,"Player %c wins!\n",player);
-                break;
-            }
+    playGame(&game, mode, isComputer, NULL);
 
-            if (isBoardFull(size)) {
-                showBoard(size);
-                printf("It's a draw!\n");
-                fprintf(logFile,"Game ended in a draw.\n");
-                break;
-            }
+    if (!textLog) {
+        moveLogClose(&moveLog);
+        fclose(indexFile);
+    }
+    fclose(logFile);
+    if (searchReady) searchFree(&engine);
+    if (mctsReady) mctsFree(&treeSearch);
+    if (multiReady) multiFree(&multiSearch);
+    printf("Thanks for playing!\n");
+    return 0;
+}
 
-            currentPlayerIndex = (currentPlayerIndex+1)%2;
+// Pick the computer player for a game and allocate it the first time
+int setupComputer(int size, int mode) {
+    // Alpha-beta only knows two sides, so three-player games search as
+    // the mover against the other two
+    computerAi = requestedAi;
+    if (computerAi == AI_AUTO || (computerAi == AI_SEARCH && mode == 3))
+        computerAi = (mode == 3) ? AI_PARANOID : AI_SEARCH;
+    if (computerAi == AI_SEARCH) {
+        if (!searchReady && !searchInit(&engine, &searchConfig)) {
+            printf("Couldn't allocate the search table. Exiting.\n");
+            return 0;
+        }
+        searchReady = 1;
+        // Fixed depths either crawl or finish too soon on big boards
+        engine.config.timeMs = searchConfig.timeMs;
+        if (size >= 6 && searchConfig.maxDepth == 0 && searchConfig.timeMs == 0)
+            engine.config.timeMs = 50;
+    }
+    if (computerAi == AI_MCTS) {
+        if (!mctsReady && !mctsInit(&treeSearch, &mctsConfig)) {
+            printf("Couldn't allocate the search tree. Exiting.\n");
+            return 0;
         }
+        mctsReady = 1;
+    }
+    if (computerAi == AI_MAXN || computerAi == AI_PARANOID) {
+        if (!multiReady && !multiInit(&multiSearch, &multiConfig)) {
+            printf("Couldn't allocate the search table. Exiting.\n");
+            return 0;
+        }
+        multiReady = 1;
+        multiSearch.config.mode = (computerAi == AI_MAXN) ? MULTI_MAXN : MULTI_PARANOID;
+        multiSearch.config.timeMs = multiConfig.timeMs;
+        if (size >= 6 && multiConfig.maxDepth == 0 && multiConfig.timeMs == 0)
+            multiSearch.config.timeMs = 50;
+    }
+    return 1;
+}
 
-        else if (mode == 2) { // Player vs Computer
-            char player = (currentPlayerIndex==0)?'X':'O';
-            if (currentPlayerIndex==0)
-                promptPlayerMove(size,player);
-            else
-                computerMove(size,player);
+// The game loop. Interactive games show the board and prompt for moves;
+// scripted ones take the humans' moves from the script and print
+// nothing. Returns 0 if the input ran out before the game ended.
+int playGame(Game *game, int mode, const int isComputer[], Script *script) {
+    while (1) {
+        char player = playerSymbols[game->toMove];
+        if (!script) showBoard(game);
 
-            saveBoardState(size);
-            if (hasPlayerWon(size, player)) {
-                showBoard(size);
-                printf("Player %c wins!\n",player);
-                fprintf(logFile,"Player %c wins!\n",player);
-                break;
-            }
+        if (mode == 3 && !script)
+            printf("Player %c's turn.\n",player);
+        if (isComputer[game->toMove])
+            computerMove(game);
+        else if (!script) {
+            if (promptPlayerMove(game, isComputer) == -1)
+                return 0;
+        } else if (scriptedPlayerMove(game, isComputer, script) == -1)
+            return 0;
 
-            if (isBoardFull(size)) {
-                showBoard(size);
+        if (game->result != GAME_PLAYING) {
+            if (script) return 1;
+            showBoard(game);
+            if (game->result == GAME_DRAW)
                 printf("It's a draw!\n");
-                fprintf(logFile,"Game ended in a draw.\n");
-                break;
-            }
-
-            currentPlayerIndex = (currentPlayerIndex+1)%2;
-        }
-
-        else if (mode == 3) { // Multi-Player (3 players)
-            char player = symbols[currentPlayerIndex];
-            printf("Player %c's turn.\n",player);
-            if (isComputer[currentPlayerIndex]==0)
-                promptPlayerMove(size,player);
             else
-                computerMove(size,player);
-
-            saveBoardState(size);
-            if (hasPlayerWon(size, player)) {
-                showBoard(size);
                 printf("Player %c wins!\n",player);
-                fprintf(logFile,"Player %c wins!\n",player);
-                break;
-            }
-
-            if (isBoardFull(size)) {
-                showBoard(size);
-                printf("It's a draw!\n");
-                fprintf(logFile,"Game ended in a draw.\n");
-                break;
-            }
-
-            currentPlayerIndex = (currentPlayerIndex+1)%3;
+            return 1;
         }
     }
-
-    fclose(logFile);
-    printf("Thanks for playing!\n");
-    return 0;
 }
 
-// Fill the board with numbered strings
-void setupBoard(int size) {
-    int count = 0;
-    for (int i=0;i<size;i++)
-        for (int j=0;j<size;j++)
-            sprintf(board[i][j],"%d",count++);
-}
-
-// Display the current board
-void showBoard(int size) {
-    printf("\n");
-    for (int i=0;i<size;i++) {
-        printf("   ");
-        for (int j=0;j<size;j++) {
-            printf(" %2s ",board[i][j]);
-            if (j<size-1) printf("|");
+// Play every game in a script, one per line:
+//
+//   size mode [O-computer Z-computer] moves...
+//
+// with y/n for the two role answers in mode 3 only, and the human moves
+// as cell numbers, or u and r to take a move back and play it again;
+// computer moves are made as usual. Blank lines and
+// lines starting with # are skipped. Each game prints one line: its
+// number, the winner's symbol, "draw" or "unfinished", and the moves
+// played. Bad moves are skipped and listed together at the end.
+int runScript(FILE *in, FILE *logFile) {
+    char *text = NULL;
+    size_t capacity = 0;
+    int line = 0, games = 0, bad = 0;
+    Game game;
+
+    while (getline(&text, &capacity, in) != -1) {
+        Script script = {text, ++line};
+        int size, mode, used, isComputer[3] = {0, 0, 0};
+        char first, answers[2];
+
+        if (sscanf(text, " %c", &first) != 1 || first == '#')
+            continue;
+        if (sscanf(script.next, "%d %d%n", &size, &mode, &used) != 2 ||
+            size < MIN_SIZE || size > MAX_SIZE || mode < 1 || mode > 3) {
+            fprintf(stderr, "Line %d: expected a size and a mode.\n", line);
+            bad++;
+            continue;
         }
-        printf("\n");
-        if (i<size-1) {
-            printf("   ");
-            for (int k=0;k<size;k++) {
-                printf("----");
-                if (k<size-1) printf("+");
+        script.next += used;
+        if (mode == 2)
+            isComputer[1] = 1;
+        if (mode == 3) {
+            if (sscanf(script.next, " %c %c%n", &answers[0], &answers[1], &used) != 2) {
+                fprintf(stderr, "Line %d: mode 3 needs y/n for O and Z.\n", line);
+                bad++;
+                continue;
             }
-            printf("\n");
+            script.next += used;
+            isComputer[1] = (answers[0] == 'y' || answers[0] == 'Y') ? 1 : 0;
+            isComputer[2] = (answers[1] == 'y' || answers[1] == 'Y') ? 1 : 0;
         }
+        if (!setupComputer(size, mode)) return 1;
+
+        gameInit(&game, size, (mode == 3) ? 3 : 2, textLog ? logFile : NULL);
+        if (!textLog) game.moveLog = &moveLog;
+        playGame(&game, mode, isComputer, &script);
+        games++;
+        if (game.result == GAME_DRAW)
+            printf("%d draw %d\n", games, game.moveCount);
+        else if (game.result != GAME_PLAYING)
+            printf("%d %c %d\n", games, playerSymbols[game.result], game.moveCount);
+        else
+            printf("%d unfinished %d\n", games, game.moveCount);
+    }
+    free(text);
+    fflush(stdout);
+
+    for (int i = 0; i < scriptErrorCount; i++) {
+        ScriptError *e = &scriptErrors[i];
+        fprintf(stderr, "Line %d, move %d: %s %s\n", e->line, e->ply + 1, e->text,
+                e->result == MOVE_TAKEN ? "is taken" :
+                e->result == MOVE_OUT_OF_RANGE ? "is off the board" :
+                e->result == -2 ? "has nothing to undo or redo" : "is not a cell number");
     }
-    printf("\n");
+    if (scriptErrorCount || scriptErrorsUnlisted || bad)
+        fprintf(stderr, "%d bad moves, %d bad lines.\n", scriptErrorCount + scriptErrorsUnlisted, bad);
+    free(scriptErrors);
+    if (searchReady) searchFree(&engine);
+    if (mctsReady) mctsFree(&treeSearch);
+    if (multiReady) multiFree(&multiSearch);
+    return (scriptErrorCount || scriptErrorsUnlisted || bad) ? 2 : 0;
 }
 
-// Save board state
-void saveBoardState(int size) {
-    for (int i=0;i<size;i++) {
-        for (int j=0;j<size;j++)
-            fprintf(logFile,"%s ",board[i][j]);
-        fprintf(logFile,"\n");
-    }
-    fprintf(logFile,"---------------------\n");
+// Display the current board; anything printf has buffered goes out first
+void showBoard(const Game *game) {
+    fflush(stdout);
+    rendererDraw(&screen, &game->board);
 }
 
-// Prompt for human move
-void promptPlayerMove(int size, char player) {
-    int move,row,col;
-    char moveStr[4];
+// Prompt for human move, returns the cell played, -2 after an undo or
+// redo, or -1 at the end of the input
+int promptPlayerMove(Game *game, const int isComputer[]) {
+    int size = game->board.size, move;
+    char text[16], *end;
     while (1) {
-        printf("Player %c, choose a cell number (0 to %d): ",player,size*size-1);
-        scanf("%d",&move);
-        if (move<0||move>=size*size) {
-            printf("Invalid number. Try again.\n");
+        printf("Player %c, choose a cell number (0 to %d): ",playerSymbols[game->toMove],size*size-1);
+        fflush(stdout);
+        startPondering(game, isComputer);
+        if (scanf("%15s", text) != 1) {
+            stopPondering();
+            return -1;
+        }
+        stopPondering();
+        if (strcmp(text, "u") == 0 || strcmp(text, "r") == 0) {
+            ponder.seconds = 0;         // it was for a position that's gone
+            if ((text[0] == 'u' ? undoMove(game, isComputer) : redoMove(game, isComputer)) > 0)
+                return -2;
+            printf("There's no move to %s.\n", text[0] == 'u' ? "take back" : "play again");
             continue;
         }
-        row = move/size;
-        col = move%size;
-        sprintf(moveStr,"%d",move);
-        if (strcmp(board[row][col],moveStr)==0) {
-            sprintf(board[row][col],"%c",player);
+        move = (int)strtol(text, &end, 10);
+        if (*end || end == text) move = -1;
+        switch (gamePlay(game, move)) {
+        case MOVE_OK:
+            return move;
+        case MOVE_OUT_OF_RANGE:
+            printf("Invalid number. Try again.\n");
             break;
-        } else {
+        default:
             printf("That spot's taken. Try again.\n");
+            break;
         }
     }
 }
 
-// Random computer move
-void computerMove(int size, char computerSymbol) {
-    int move,row,col;
-    char moveStr[12];
-    printf("Computer (%c) is making a move...\n",computerSymbol);
+// Next human move from a script line, returns the cell played, -2 after
+// an undo or redo, or -1 once the line runs out. Bad cells are noted and
+// skipped.
+int scriptedPlayerMove(Game *game, const int isComputer[], Script *script) {
     while (1) {
-        move = rand()%(size*size);
-        row = move/size;
-        col = move%size;
-        sprintf(moveStr,"%d",move);
-        if (strcmp(board[row][col],moveStr)==0) {
-            sprintf(board[row][col],"%c",computerSymbol);
-            break;
+        char *end;
+        long move;
+        int result;
+        while (*script->next == ' ' || *script->next == '\t') script->next++;
+        if (*script->next == '\0' || *script->next == '\n' || *script->next == '\r')
+            return -1;
+        move = strtol(script->next, &end, 10);
+        if ((*script->next == 'u' || *script->next == 'r') &&
+            (script->next[1] == '\0' || strchr(" \t\r\n", script->next[1]))) {
+            end = script->next + 1;
+            if ((*script->next == 'u' ? undoMove(game, isComputer) : redoMove(game, isComputer)) > 0) {
+                script->next = end;
+                return -2;
+            }
+            result = -2;
+        } else if (end == script->next || (*end && *end != ' ' && *end != '\t' && *end != '\n' && *end != '\r')) {
+            while (*end && *end != ' ' && *end != '\t' && *end != '\n' && *end != '\r') end++;
+            result = -1;
+        } else {
+            result = gamePlay(game, move < 0 || move > MAX_CELLS ? -1 : (int)move);
+            if (result == MOVE_OK) {
+                script->next = end;
+                return (int)move;
+            }
+        }
+        if (scriptErrorCount == scriptErrorCap) {
+            int cap = scriptErrorCap ? 2 * scriptErrorCap : 64;
+            ScriptError *grown = realloc(scriptErrors, cap * sizeof *grown);
+            if (grown) {
+                scriptErrors = grown;
+                scriptErrorCap = cap;
+            }
         }
+        // Out of memory for the list: the move is still skipped and counted
+        if (scriptErrorCount < scriptErrorCap) {
+            scriptErrors[scriptErrorCount].line = script->line;
+            scriptErrors[scriptErrorCount].ply = game->moveCount;
+            scriptErrors[scriptErrorCount].result = result;
+            snprintf(scriptErrors[scriptErrorCount].text, sizeof scriptErrors[0].text, "%.*s",
+                     (int)(end - script->next), script->next);
+            scriptErrorCount++;
+        } else
+            scriptErrorsUnlisted++;
+        script->next = end;
     }
 }
 
-// Win check
-int hasPlayerWon(int size, char player) {
-    char pStr[2]={player,'\0'};
-    int winLength=(size>=4)?4:size;
-
-    // Rows
-    for (int i=0;i<size;i++)
-        for (int j=0;j<=size-winLength;j++) {
-            int count=0;
-            for (int k=0;k<winLength;k++)
-                if (strcmp(board[i][j+k],pStr)==0) count++;
-            if (count==winLength) return 1;
-        }
+// Take back moves until a human is to move again, so undoing against the
+// computer also takes back its reply. Returns how many were taken back.
+int undoMove(Game *game, const int isComputer[]) {
+    int undone = 0;
+    while (gameUndo(game) >= 0) {
+        undone++;
+        if (!isComputer[game->toMove]) break;
+    }
+    // Only computers' moves left: replay them, there's nothing to take back
+    if (undone > 0 && isComputer[game->toMove])
+        while (undone > 0 && gameRedo(game) >= 0) undone--;
+    return undone;
+}
 
-    // Columns
-    for (int j=0;j<size;j++)
-        for (int i=0;i<=size-winLength;i++) {
-            int count=0;
-            for (int k=0;k<winLength;k++)
-                if (strcmp(board[i+k][j],pStr)==0) count++;
-            if (count==winLength) return 1;
-        }
+// Play taken-back moves again up to the next human turn, returns how many
+int redoMove(Game *game, const int isComputer[]) {
+    int redone = 0;
+    while (gameRedo(game) >= 0) {
+        redone++;
+        if (!isComputer[game->toMove] || game->result != GAME_PLAYING) break;
+    }
+    return redone;
+}
 
-    // Diagonals TL-BR
-    for (int i=0;i<=size-winLength;i++)
-        for (int j=0;j<=size-winLength;j++) {
-            int count=0;
-            for (int k=0;k<winLength;k++)
-                if (strcmp(board[i+k][j+k],pStr)==0) count++;
-            if (count==winLength) return 1;
+// Computer move, returns the cell played
+int computerMove(Game *game) {
+    int move, me = game->toMove;
+    if (!scripted)
+        printf("Computer (%c) is making a move...\n",playerSymbols[me]);
+    if (computerAi == AI_SEARCH) {
+        // Solved positions are a table lookup
+        move = perfectMove(game->board.size == 3 ? &perfect3 : &perfect4, &game->board, me, 1 - me, NULL);
+        if (move < 0) {
+            int timeMs = engine.config.timeMs;
+            engine.config.timeMs = ponderedBudget(timeMs);
+            move = searchBestMove(&engine, &game->board, me, 1 - me, NULL);
+            engine.config.timeMs = timeMs;
         }
+    } else if (computerAi == AI_MCTS)
+        move = mctsBestMove(&treeSearch, &game->board, me, game->players, NULL);
+    else if (computerAi == AI_MAXN || computerAi == AI_PARANOID) {
+        int timeMs = multiSearch.config.timeMs;
+        multiSearch.config.timeMs = ponderedBudget(timeMs);
+        move = multiBestMove(&multiSearch, &game->board, me, game->players, NULL);
+        multiSearch.config.timeMs = timeMs;
+    } else
+        move = boardRandomFreeCell(&game->board);
+    ponder.seconds = 0;
+    gamePlay(game, move);
+    return move;
+}
 
-    // Diagonals TR-BL
-    for (int i=0;i<=size-winLength;i++)
-        for (int j=winLength-1;j<size;j++) {
-            int count=0;
-            for (int k=0;k<winLength;k++)
-                if (strcmp(board[i+k][j-k],pStr)==0) count++;
-            if (count==winLength) return 1;
-        }
+// Ponder for the computer who moves after this human, unless there's
+// nothing to gain: random moves, or a 3x3 or 4x4 that the perfect-play
+// tables answer
+void startPondering(const Game *game, const int isComputer[]) {
+    const int size = game->board.size, next = (game->toMove + 1) % game->players;
+    // Asked again after a typo: the time already spent still counts
+    if (memcmp(game->board.pieces, ponder.board.pieces, sizeof ponder.board.pieces) != 0 ||
+        game->toMove != ponder.toMove)
+        ponder.seconds = 0;
+    if (ponder.running || !isComputer[next] || computerAi == AI_RANDOM) return;
+    if (computerAi == AI_SEARCH && (size == 3 || (size == 4 && perfect4.slots))) return;
+    ponder.stop = 0;
+    ponder.board = game->board;
+    ponder.toMove = game->toMove;
+    ponder.players = game->players;
+    ponder.computer = next;
+    clock_gettime(CLOCK_MONOTONIC, &ponder.started);
+    ponder.running = pthread_create(&ponder.thread, NULL, ponderMain, &ponder) == 0;
+}
 
-    return 0;
+// Stop the ponder and wait for it, so the engine is free again
+void stopPondering(void) {
+    struct timespec now;
+    if (!ponder.running) return;
+    __atomic_store_n(&ponder.stop, 1, __ATOMIC_RELAXED);
+    pthread_join(ponder.thread, NULL);
+    ponder.running = 0;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    ponder.seconds += (now.tv_sec - ponder.started.tv_sec) + (now.tv_nsec - ponder.started.tv_nsec) / 1e9;
 }
 
-// Board full?
-int isBoardFull(int size) {
-    for (int i=0;i<size;i++)
-        for (int j=0;j<size;j++)
-            if (strcmp(board[i][j],"X")!=0 &&
-                strcmp(board[i][j],"O")!=0 &&
-                strcmp(board[i][j],"Z")!=0)
-                return 0;
-    return 1;
+void *ponderMain(void *arg) {
+    Ponder *p = arg;
+    if (computerAi == AI_SEARCH)
+        searchPonder(&engine, &p->board, p->toMove, p->computer, &p->stop);
+    else if (computerAi == AI_MCTS)
+        mctsPonder(&treeSearch, &p->board, p->toMove, p->players, &p->stop);
+    else
+        multiPonder(&multiSearch, &p->board, p->toMove, p->players, p->computer, &p->stop);
+    return NULL;
 }
 
+// A time budget less what the ponder already spent on this position, but
+// never under a third of it: the table holds most of the tree under the
+// move that was played, not all of it, and with a third the search gets
+// as deep as it would from cold with the whole budget. MCTS does its own
+// sums from the playouts it kept.
+int ponderedBudget(int timeMs) {
+    int left = timeMs - (int)(ponder.seconds * 1000), floor = timeMs / 3 > 1 ? timeMs / 3 : 1;
+    if (timeMs == 0 || ponder.seconds == 0) return timeMs;
+    return left > floor ? left : floor;
+}
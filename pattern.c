@@ -0,0 +1,143 @@
+#include <string.h>
+#include "pattern.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define PATTERN_X86 1
+#endif
+
+#define ALWAYS_INLINE static inline __attribute__((always_inline))
+
+const char *const patternImplNames[PATTERN_IMPLS] = {"scalar", "sse2", "avx2"};
+
+// The reference, one segment at a time: a player's nibble is open when
+// it's the whole word. Empty segments land in [p][0], cleared after.
+static void countScalar(const Board *b, int players, Patterns *out) {
+    const LineTable *t = boardLines(b);
+    memset(out, 0, sizeof *out);
+    for (int i = 0; i < t->count; i++) {
+        unsigned c = b->lineCounts[i];
+        for (int p = 0; p < players; p++) {
+            unsigned k = (c >> (4 * p)) & 0xF;
+            out->open[p][k] += c == k << (4 * p);
+        }
+    }
+    for (int p = 0; p < players; p++)
+        out->open[p][0] = 0;
+}
+
+#ifdef PATTERN_X86
+// Each accumulator lane subtracts the all-ones compare result, so it
+// counts matches; with at most 32 blocks a 16-bit lane can't overflow.
+// Words past the last segment are 0 and never match.
+
+static int sumSse2(__m128i v) {
+    v = _mm_madd_epi16(v, _mm_set1_epi16(1));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0x4E));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0xB1));
+    return _mm_cvtsi128_si32(v);
+}
+
+ALWAYS_INLINE void countSse2For(const Board *b, int players, Patterns *out) {
+    const int blocks = (boardLines(b)->count + 7) / 8;
+    __m128i acc[MAX_PLAYERS][4];
+    memset(out, 0, sizeof *out);
+#pragma GCC unroll 3
+    for (int p = 0; p < players; p++)
+#pragma GCC unroll 4
+        for (int k = 0; k < 4; k++)
+            acc[p][k] = _mm_setzero_si128();
+    for (int i = 0; i < blocks; i++) {
+        __m128i c = _mm_loadu_si128((const __m128i *)&b->lineCounts[8 * i]);
+#pragma GCC unroll 3
+        for (int p = 0; p < players; p++)
+#pragma GCC unroll 4
+            for (int k = 0; k < 4; k++)
+                acc[p][k] = _mm_sub_epi16(acc[p][k],
+                                          _mm_cmpeq_epi16(c, _mm_set1_epi16((short)((k + 1) << (4 * p)))));
+    }
+    for (int p = 0; p < players; p++)
+        for (int k = 0; k < 4; k++)
+            out->open[p][k + 1] = sumSse2(acc[p][k]);
+}
+
+static void countSse2(const Board *b, int players, Patterns *out) {
+    if (players == 3) countSse2For(b, 3, out);
+    else countSse2For(b, 2, out);
+}
+
+#define AVX2 __attribute__((target("avx2")))
+
+AVX2 static int sumAvx2(__m256i v) {
+    return sumSse2(_mm_add_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+}
+
+AVX2 ALWAYS_INLINE void countAvx2For(const Board *b, int players, Patterns *out) {
+    const int blocks = (boardLines(b)->count + 15) / 16;
+    __m256i acc[MAX_PLAYERS][4];
+    memset(out, 0, sizeof *out);
+#pragma GCC unroll 3
+    for (int p = 0; p < players; p++)
+#pragma GCC unroll 4
+        for (int k = 0; k < 4; k++)
+            acc[p][k] = _mm256_setzero_si256();
+    for (int i = 0; i < blocks; i++) {
+        __m256i c = _mm256_loadu_si256((const __m256i *)&b->lineCounts[16 * i]);
+#pragma GCC unroll 3
+        for (int p = 0; p < players; p++)
+#pragma GCC unroll 4
+            for (int k = 0; k < 4; k++)
+                acc[p][k] = _mm256_sub_epi16(acc[p][k],
+                                             _mm256_cmpeq_epi16(c, _mm256_set1_epi16((short)((k + 1) << (4 * p)))));
+    }
+    for (int p = 0; p < players; p++)
+        for (int k = 0; k < 4; k++)
+            out->open[p][k + 1] = sumAvx2(acc[p][k]);
+}
+
+AVX2 static void countAvx2(const Board *b, int players, Patterns *out) {
+    if (players == 3) countAvx2For(b, 3, out);
+    else countAvx2For(b, 2, out);
+}
+#endif
+
+typedef void (*CountFn)(const Board *b, int players, Patterns *out);
+
+static CountFn impls[PATTERN_IMPLS];
+static CountFn best = countScalar;
+
+// Pick the implementations this CPU can run, before main
+__attribute__((constructor))
+static void patternInit(void) {
+    impls[PATTERN_SCALAR] = countScalar;
+#ifdef PATTERN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse2")) best = impls[PATTERN_SSE2] = countSse2;
+    if (__builtin_cpu_supports("avx2")) best = impls[PATTERN_AVX2] = countAvx2;
+#endif
+}
+
+void patternCount(const Board *b, int players, Patterns *out) {
+    best(b, players, out);
+}
+
+int patternCountWith(int impl, const Board *b, int players, Patterns *out) {
+    if (impl < 0 || impl >= PATTERN_IMPLS || !impls[impl]) return 0;
+    impls[impl](b, players, out);
+    return 1;
+}
+
+int patternValue(const Patterns *p, int player) {
+    static const int weight[5] = {0, 1, 8, 64, 512};
+    int value = 0;
+    for (int k = 1; k < 5; k++)
+        value += weight[k] * p->open[player][k];
+    return value;
+}
+
+int patternScore(const Patterns *p, int me, int players) {
+    int score = 0;
+    for (int q = 0; q < players; q++)
+        score += (q == me) ? patternValue(p, q) : -patternValue(p, q);
+    return score;
+}
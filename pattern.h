@@ -0,0 +1,34 @@
+#ifndef PATTERN_H
+#define PATTERN_H
+
+#include "board.h"
+
+// Open windows: winning segments holding k pieces of one player and none
+// of anybody else's, so that player could still fill them (open twos,
+// open threes and so on). They are read straight off the line counts the
+// board keeps, one 16-bit word per segment with 4 bits per player: a
+// segment is open for player p with k pieces exactly when its word is
+// k << 4p. Counting is then one compare per player and k, on 8 segments
+// at a time with SSE2 or 16 with AVX2.
+typedef struct {
+    int open[MAX_PLAYERS][5];     // [player][pieces]; [p][0] is always 0
+} Patterns;
+
+enum { PATTERN_SCALAR, PATTERN_SSE2, PATTERN_AVX2, PATTERN_IMPLS };
+
+extern const char *const patternImplNames[PATTERN_IMPLS];
+
+// Count with the fastest implementation this CPU has. players is 2 or 3;
+// with 2 the Z counts are left at 0.
+void patternCount(const Board *b, int players, Patterns *out);
+
+// Count with a given implementation; returns 0 if this build or CPU
+// doesn't have it
+int  patternCountWith(int impl, const Board *b, int players, Patterns *out);
+
+// One player's open windows, weighted by how full they are
+int  patternValue(const Patterns *p, int player);
+// Weighted open windows for me minus everybody else's
+int  patternScore(const Patterns *p, int me, int players);
+
+#endif
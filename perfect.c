@@ -0,0 +1,97 @@
+#define _POSIX_C_SOURCE 200809L
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "perfect.h"
+
+static const uint32_t pow3[PERFECT_MAX_CELLS] = {
+    1, 3, 9, 27, 81, 243, 729, 2187, 6561, 19683, 59049, 177147,
+    531441, 1594323, 4782969, 14348907,
+};
+
+// Key of the position once symmetry has moved every piece
+static uint32_t transformedKey(const unsigned char *to, uint32_t mover, uint32_t opponent) {
+    uint32_t key = 0;
+    for (; mover; mover &= mover - 1)
+        key += pow3[to[__builtin_ctz(mover)]];
+    for (; opponent; opponent &= opponent - 1)
+        key += 2 * pow3[to[__builtin_ctz(opponent)]];
+    return key;
+}
+
+// Smallest key over the symmetries of a 3x3 or 4x4 position, and which
+// symmetry gave it
+uint32_t perfectKey(int size, uint32_t mover, uint32_t opponent, int *symmetry) {
+    uint32_t best = PERFECT_EMPTY;
+    for (int s = 0; s < SYMMETRIES; s++) {
+        uint32_t key = transformedKey(symmetryCells[size][s], mover, opponent);
+        if (key < best) {
+            best = key;
+            if (symmetry) *symmetry = s;
+        }
+    }
+    return best;
+}
+
+int perfectLoad(PerfectTable *t, const char *path) {
+    struct stat st;
+    const unsigned char *data;
+    uint32_t slots;
+    int fd = open(path, O_RDONLY);
+    memset(t, 0, sizeof *t);
+    if (fd < 0) return 0;
+    if (fstat(fd, &st) < 0 || st.st_size < PERFECT_HEADER) {
+        close(fd);
+        return 0;
+    }
+    data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) return 0;
+
+    memcpy(&slots, data + 8, sizeof slots);
+    if (memcmp(data, "TTTP", 4) != 0 || data[4] != PERFECT_VERSION ||
+        data[5] < 3 || data[5] > 4 || data[6] != boardWinLength(data[5]) ||
+        slots == 0 || (slots & (slots - 1)) != 0 ||
+        (size_t)st.st_size != PERFECT_HEADER + (size_t)slots * 5) {
+        munmap((void *)data, (size_t)st.st_size);
+        return 0;
+    }
+    t->size = data[5];
+    t->slots = slots;
+    t->keys = (const uint32_t *)(data + PERFECT_HEADER);
+    t->entries = data + PERFECT_HEADER + (size_t)slots * 4;
+    t->map = (void *)data;
+    t->mapLength = (size_t)st.st_size;
+    return 1;
+}
+
+void perfectUnload(PerfectTable *t) {
+    if (t->map) munmap(t->map, t->mapLength);
+    memset(t, 0, sizeof *t);
+}
+
+// The perfect move for player in a two-player position, or -1 if the
+// table doesn't cover it (another size, no table loaded, a third
+// player's pieces, or the game is over)
+int perfectMove(const PerfectTable *t, const Board *b, int player, int opponent, int *outcome) {
+    uint32_t mover = 0, opponentMask = 0, key, slot;
+    Bits rowMask;
+    int symmetry = 0;
+    if (!t || !t->keys || b->size != t->size || b->occupied != (b->pieces[player] | b->pieces[opponent]))
+        return -1;
+
+    rowMask = ((Bits)1 << b->size) - 1;
+    for (int row = 0; row < b->size; row++) {
+        int shift = row * b->stride;
+        mover |= (uint32_t)((b->pieces[player] >> shift) & rowMask) << (row * b->size);
+        opponentMask |= (uint32_t)((b->pieces[opponent] >> shift) & rowMask) << (row * b->size);
+    }
+    key = perfectKey(b->size, mover, opponentMask, &symmetry);
+    for (slot = perfectSlot(key, t->slots); t->keys[slot] != key; slot = (slot + 1) & (t->slots - 1))
+        if (t->keys[slot] == PERFECT_EMPTY) return -1;
+
+    if (outcome) *outcome = perfectEntryOutcome(t->entries[slot]);
+    return symmetryCell(b->size, symmetryInverse[symmetry], perfectEntryMove(t->entries[slot]));
+}
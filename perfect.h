@@ -0,0 +1,61 @@
+#ifndef PERFECT_H
+#define PERFECT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "board.h"
+
+// Perfect-play tables for two-player 3x3 and 4x4 (four in a row), written
+// by solve.c. A position is keyed from the mover's side: one base-3 digit
+// per cell, 1 for the mover's piece and 2 for the opponent's, so it
+// doesn't matter who went first or which symbols are playing. Of the
+// eight rotations and reflections of a position only the one with the
+// smallest key is stored.
+//
+// A table is open addressing on that key, keys[slots] next to
+// entries[slots]. An entry holds the best move in the stored orientation
+// (the fastest win, or the slowest loss) in its low 4 bits and the
+// outcome for the mover above them. Finished positions aren't stored.
+//
+// The 4x4 table file is a 16-byte header, 'T' 'T' 'T' 'P' version size
+// winLength 0 then the slot count as a 32-bit integer and 4 spare bytes,
+// followed by both arrays in the machine's own byte order.
+
+#define PERFECT_VERSION 1
+#define PERFECT_HEADER 16
+#define PERFECT_EMPTY 0xFFFFFFFFu   // key of an unused slot
+#define PERFECT_MAX_CELLS 16
+
+enum { PERFECT_LOSS, PERFECT_DRAW, PERFECT_WIN };
+
+typedef struct {
+    int size;
+    uint32_t slots;               // power of two
+    const uint32_t *keys;
+    const uint8_t *entries;
+    void *map;                    // the mapped file, NULL if compiled in
+    size_t mapLength;
+} PerfectTable;
+
+// The 3x3 table, compiled in from perfect3.c
+extern const PerfectTable perfect3;
+
+static inline int perfectEntryMove(uint8_t entry) {
+    return entry & 15;
+}
+
+static inline int perfectEntryOutcome(uint8_t entry) {
+    return entry >> 4;
+}
+
+static inline uint32_t perfectSlot(uint32_t key, uint32_t slots) {
+    return (uint32_t)((key * 0x9E3779B1u) >> 8) & (slots - 1);
+}
+
+// Masks here are plain row-major cell masks (bit i is cell i), not Bits
+uint32_t perfectKey(int size, uint32_t mover, uint32_t opponent, int *symmetry);
+int      perfectLoad(PerfectTable *t, const char *path);
+void     perfectUnload(PerfectTable *t);
+int      perfectMove(const PerfectTable *t, const Board *b, int player, int opponent, int *outcome);
+
+#endif
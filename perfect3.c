@@ -0,0 +1,224 @@
+// Generated by solve.c (./solve 3 -c > perfect3.c), do not edit
+#include "perfect.h"
+
+static const uint32_t keys[1024] = {
+    0, 1136, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 2089, PERFECT_EMPTY, PERFECT_EMPTY,
+    PERFECT_EMPTY, 1784, PERFECT_EMPTY, PERFECT_EMPTY, 7769, 1479, 160, 1357,
+    5009, 7525, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 808, 747,
+    PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 320, PERFECT_EMPTY, 2653,
+    76, 3911, 1151, PERFECT_EMPTY, 3545, 8516, PERFECT_EMPTY, PERFECT_EMPTY,
+    1982, 1921, 1799, 480, 541, 5695, 297, PERFECT_EMPTY,
+    PERFECT_EMPTY, PERFECT_EMPTY, 1250, 2508, 3583, 3461, 3400, 884,
+    PERFECT_EMPTY, PERFECT_EMPTY, 5611, 1776, 4231, 396, 4048, PERFECT_EMPTY,
+    1410, 152, 1288, PERFECT_EMPTY, PERFECT_EMPTY, 1044, PERFECT_EMPTY, PERFECT_EMPTY,
+    2058, 800, 8287, 10742, 556, 1753, 434, 312,
+    4147, PERFECT_EMPTY, PERFECT_EMPTY, 7, 68, 1265, 8630, 960,
+    PERFECT_EMPTY, PERFECT_EMPTY, 1974, PERFECT_EMPTY, 4307, PERFECT_EMPTY, 1730, PERFECT_EMPTY,
+    PERFECT_EMPTY, 228, 167, 1425, 45, 1181, 3575, PERFECT_EMPTY,
+    3453, 3392, 2073, 754, 632, 5603, 4223, 449,
+    1707, 8363, PERFECT_EMPTY, PERFECT_EMPTY, 83, 1280, 1158, PERFECT_EMPTY,
+    3491, 914, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 1806, 1745,
+    PERFECT_EMPTY, 1562, 304, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 8683, 7364,
+    PERFECT_EMPTY, PERFECT_EMPTY, 2149, 830, PERFECT_EMPTY, 1966, 1905, 10528,
+    464, 403, 1722, 4177, PERFECT_EMPTY, 98, 1356, 1234,
+    2492, 1051, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 746, 5717, 624,
+    PERFECT_EMPTY, PERFECT_EMPTY, 380, PERFECT_EMPTY, PERFECT_EMPTY, 2652, 75, 1272,
+    1211, 4924, 1028, 967, 906, 3422, PERFECT_EMPTY, 1920,
+    5633, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 1371, 52,
+    2507, PERFECT_EMPTY, 1127, PERFECT_EMPTY, PERFECT_EMPTY, 3399, 8309, 1958,
+    1897, PERFECT_EMPTY, PERFECT_EMPTY, 4169, 395, 4047, 212, 1409,
+    2667, 1226, PERFECT_EMPTY, PERFECT_EMPTY, 1043, 3437, PERFECT_EMPTY, 2057,
+    PERFECT_EMPTY, 1874, 8042, 1752, 4207, PERFECT_EMPTY, 1508, PERFECT_EMPTY,
+    128, PERFECT_EMPTY, 6, 1142, 1203, 3475, 3597, 2095,
+    776, 7310, 1851, 1790, 4245, 12220, PERFECT_EMPTY, 2743,
+    PERFECT_EMPTY, 7531, 44, 1302, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 936,
+    PERFECT_EMPTY, 753, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 1706, PERFECT_EMPTY, PERFECT_EMPTY,
+    PERFECT_EMPTY, 204, PERFECT_EMPTY, 8705, 1157, 14873, PERFECT_EMPTY, PERFECT_EMPTY,
+    2110, PERFECT_EMPTY, PERFECT_EMPTY, 1927, 1805, 1866, PERFECT_EMPTY, 4138,
+    303, 2819, 1378, 7607, PERFECT_EMPTY, 1195, 3589, PERFECT_EMPTY,
+    3467, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 1843, 4237, 402,
+    PERFECT_EMPTY, PERFECT_EMPTY, 1477, 158, 1355, 6448, 7523, 1050,
+    PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 806, PERFECT_EMPTY, 4336, PERFECT_EMPTY, PERFECT_EMPTY,
+    440, 318, 4153, 196, 1393, PERFECT_EMPTY, 8636, 8575,
+    3543, 966, PERFECT_EMPTY, PERFECT_EMPTY, 2041, 5693, PERFECT_EMPTY, PERFECT_EMPTY,
+    478, 1736, PERFECT_EMPTY, PERFECT_EMPTY, 173, PERFECT_EMPTY, 51, 1248,
+    3581, PERFECT_EMPTY, PERFECT_EMPTY, 882, 3398, 5792, 1896, PERFECT_EMPTY,
+    1774, 455, 4229, 1591, PERFECT_EMPTY, 150, 89, 1347,
+    PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 798, 8285, PERFECT_EMPTY,
+    PERFECT_EMPTY, 554, 1751, 4145, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    5, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 5746, PERFECT_EMPTY,
+    PERFECT_EMPTY, PERFECT_EMPTY, 470, 4183, 7774, PERFECT_EMPTY, 226, 104,
+    165, 1240, 3939, 7469, 996, 935, 2071, 752,
+    2010, PERFECT_EMPTY, 4282, 7934, 386, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    142, 1278, 1217, 3611, 1034, 8521, 912, 10793,
+    1987, 5639, 5761, 4259, PERFECT_EMPTY, PERFECT_EMPTY, 302, 1560,
+    PERFECT_EMPTY, 1316, PERFECT_EMPTY, 1194, 8681, PERFECT_EMPTY, PERFECT_EMPTY, 889,
+    2147, 10709, 17060, 1842, 8071, 462, 401, 1720,
+    2734, 1415, 4175, 35, 1232, 2490, 1049, 8597,
+    PERFECT_EMPTY, 2063, 2002, PERFECT_EMPTY, 622, 1758, 4335, PERFECT_EMPTY,
+    PERFECT_EMPTY, 195, 1392, 73, 1209, 1270, 1331, 2589,
+    3481, 2101, 2040, 3237, 1857, 3908, 7499, PERFECT_EMPTY,
+    PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 1369, 50, 2627, PERFECT_EMPTY, PERFECT_EMPTY,
+    PERFECT_EMPTY, 942, 10762, PERFECT_EMPTY, PERFECT_EMPTY, 637, 1895, 1712,
+    5608, 1590, PERFECT_EMPTY, 210, 2665, 1285, PERFECT_EMPTY, PERFECT_EMPTY,
+    3557, 980, PERFECT_EMPTY, 2116, 10739, 1933, 4327, PERFECT_EMPTY,
+    PERFECT_EMPTY, PERFECT_EMPTY, 2825, 1506, 1384, 65, 1262, 7369,
+    1140, PERFECT_EMPTY, 3473, PERFECT_EMPTY, 2032, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    1788, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 225, 1422, 2741, 7529,
+    PERFECT_EMPTY, 8543, 14711, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 1948, 5600,
+    4281, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 141, 1399,
+    2657, 7445, 8581, PERFECT_EMPTY, 3427, PERFECT_EMPTY, 2047, 1986,
+    PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 4136, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 2573,
+    PERFECT_EMPTY, 1193, 7361, 3587, PERFECT_EMPTY, 888, PERFECT_EMPTY, PERFECT_EMPTY,
+    PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 278, 156,
+    PERFECT_EMPTY, 5005, PERFECT_EMPTY, PERFECT_EMPTY, 3503, PERFECT_EMPTY, 10868, 804,
+    PERFECT_EMPTY, PERFECT_EMPTY, 621, 1879, 438, 4273, 316, 4334,
+    194, 1391, 11, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 964, 3419,
+    2039, 1978, PERFECT_EMPTY, PERFECT_EMPTY, 1734, PERFECT_EMPTY, 7841, PERFECT_EMPTY,
+    232, 1368, PERFECT_EMPTY, 2504, 1185, 7475, PERFECT_EMPTY, 941,
+    PERFECT_EMPTY, 2077, PERFECT_EMPTY, 8123, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 1589,
+    PERFECT_EMPTY, PERFECT_EMPTY, 1406, 87, 1284, 8710, PERFECT_EMPTY, PERFECT_EMPTY,
+    PERFECT_EMPTY, PERFECT_EMPTY, 1993, 2054, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    308, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    PERFECT_EMPTY, PERFECT_EMPTY, 834, 10715, PERFECT_EMPTY, PERFECT_EMPTY, 4303, 468,
+    1726, 4181, 7772, 163, 1421, 1238, PERFECT_EMPTY, 8603,
+    3571, 3449, PERFECT_EMPTY, 2069, 2008, PERFECT_EMPTY, 628, PERFECT_EMPTY,
+    1703, 384, 4219, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 1276, 1154,
+    PERFECT_EMPTY, 1032, 8519, 910, PERFECT_EMPTY, 1985, PERFECT_EMPTY, 1802,
+    544, PERFECT_EMPTY, PERFECT_EMPTY, 1558, PERFECT_EMPTY, 178, 1375, PERFECT_EMPTY,
+    1131, 8557, PERFECT_EMPTY, PERFECT_EMPTY, 887, 2145, 10768, 1901,
+    8069, 1718, 460, 4173, 2732, 2671, 1352, 33,
+    1230, 1169, 1291, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    1878, PERFECT_EMPTY, PERFECT_EMPTY, 4150, 315, 3967, PERFECT_EMPTY, 132,
+    PERFECT_EMPTY, 1207, 8633, PERFECT_EMPTY, 3479, 902, PERFECT_EMPTY, 780,
+    PERFECT_EMPTY, 1855, PERFECT_EMPTY, 475, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 8549, PERFECT_EMPTY, PERFECT_EMPTY, 2137, 3395,
+    PERFECT_EMPTY, 1954, 635, 1771, 452, 4165, PERFECT_EMPTY, 208,
+    2663, PERFECT_EMPTY, 1222, 1283, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    8282, 1992, 1870, 4325, 1748, 4142, 4264, 8038,
+    PERFECT_EMPTY, 1382, 63, 2, 1199, 1260, 1321, 3410,
+    2091, 2030, 3471, 5743, 7367, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    PERFECT_EMPTY, PERFECT_EMPTY, 101, 162, 1298, 1115, 5011, PERFECT_EMPTY,
+    PERFECT_EMPTY, PERFECT_EMPTY, 749, 5659, 5720, PERFECT_EMPTY, 7931, PERFECT_EMPTY,
+    322, PERFECT_EMPTY, 200, 3913, 17, PERFECT_EMPTY, 3608, PERFECT_EMPTY,
+    PERFECT_EMPTY, 909, 3425, 8335, 10790, PERFECT_EMPTY, 543, 4195,
+    4256, 299, 238, 1557, 116, 2815, 7847, PERFECT_EMPTY,
+    PERFECT_EMPTY, 3463, 3341, 2083, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    459, 398, PERFECT_EMPTY, 3989, 154, 1290, PERFECT_EMPTY, PERFECT_EMPTY,
+    3562, 1046, PERFECT_EMPTY, PERFECT_EMPTY, 802, 5773, 1877, 10744,
+    PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 314, 6421, PERFECT_EMPTY, 70, 1206,
+    PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, 1976, 1854,
+    4309, 474, 5689, PERFECT_EMPTY, PERFECT_EMPTY, 169, 230, 47,
+    1244, 1427, 8609, PERFECT_EMPTY, 2136, 2075, 10820, PERFECT_EMPTY,
+    1892, 1770, 5605, 4164, PERFECT_EMPTY, PERFECT_EMPTY, 146, 207,
+    1343, 1221, 3615, 8708, PERFECT_EMPTY, 916, 5765, 10736,
+    PERFECT_EMPTY, PERFECT_EMPTY, 550, 4263, PERFECT_EMPTY, 1564, PERFECT_EMPTY, 2639,
+    1320, 1259, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    PERFECT_EMPTY, 1907, PERFECT_EMPTY, 1724, 466, 10469, PERFECT_EMPTY, 1480,
+    1419, 2738, PERFECT_EMPTY, PERFECT_EMPTY, 3569, 992, PERFECT_EMPTY, PERFECT_EMPTY,
+    2067, PERFECT_EMPTY, 626, PERFECT_EMPTY, 1762, PERFECT_EMPTY, PERFECT_EMPTY, PERFECT_EMPTY,
+    PERFECT_EMPTY, 1396, 1274, 1213, 6367, PERFECT_EMPTY, PERFECT_EMPTY, 908,
+    PERFECT_EMPTY, 2044, PERFECT_EMPTY, 1861, PERFECT_EMPTY, 481, PERFECT_EMPTY, 2814,
+    PERFECT_EMPTY, 176, 1373, 2509, 1190, 8555, PERFECT_EMPTY, 3462,
+    2143, 2082, PERFECT_EMPTY, 1960, PERFECT_EMPTY, 1777, 1716, PERFECT_EMPTY,
+    PERFECT_EMPTY, 214, 153, 2669, 2730, PERFECT_EMPTY, PERFECT_EMPTY, 3561,
+    PERFECT_EMPTY, PERFECT_EMPTY, 801, 2059, PERFECT_EMPTY, 4331, 8044, PERFECT_EMPTY,
+    PERFECT_EMPTY, PERFECT_EMPTY, 1510, 1388, 69, 1266, 1205, 2585,
+    3599, 961, 3477, 2036, 3233, PERFECT_EMPTY, PERFECT_EMPTY, 4247,
+    473, PERFECT_EMPTY, 290, PERFECT_EMPTY, PERFECT_EMPTY, 1304, 2501, 7472,
+    PERFECT_EMPTY, PERFECT_EMPTY, 938, PERFECT_EMPTY, PERFECT_EMPTY, 5665, 8120, 4285,
+    1708, 4163, PERFECT_EMPTY, PERFECT_EMPTY, 206, 2661, 23, 1220,
+    1159, 3614, PERFECT_EMPTY, PERFECT_EMPTY, 8341, 1990, 1929, 1868,
+    1807, 1746, 4201, 7853, PERFECT_EMPTY, PERFECT_EMPTY, 1319, 61
+};
+
+static const uint8_t entries[1024] = {
+    0x10, 0x28, 0x00, 0x00, 0x00, 0x21, 0x00, 0x00, 0x00, 0x23, 0x00, 0x00,
+    0x27, 0x14, 0x28, 0x22, 0x26, 0x27, 0x00, 0x00, 0x00, 0x00, 0x28, 0x20,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x16, 0x00, 0x28, 0x24, 0x24, 0x28, 0x00,
+    0x22, 0x13, 0x00, 0x00, 0x14, 0x22, 0x23, 0x16, 0x24, 0x23, 0x10, 0x00,
+    0x00, 0x00, 0x02, 0x10, 0x23, 0x24, 0x28, 0x11, 0x00, 0x00, 0x23, 0x00,
+    0x21, 0x10, 0x28, 0x00, 0x20, 0x26, 0x01, 0x00, 0x00, 0x10, 0x00, 0x00,
+    0x12, 0x24, 0x24, 0x24, 0x24, 0x24, 0x08, 0x28, 0x13, 0x00, 0x00, 0x23,
+    0x06, 0x18, 0x17, 0x00, 0x00, 0x00, 0x12, 0x00, 0x03, 0x00, 0x24, 0x00,
+    0x00, 0x20, 0x08, 0x20, 0x20, 0x01, 0x28, 0x00, 0x20, 0x28, 0x27, 0x23,
+    0x26, 0x24, 0x21, 0x28, 0x14, 0x23, 0x00, 0x00, 0x11, 0x24, 0x00, 0x00,
+    0x22, 0x18, 0x00, 0x00, 0x00, 0x00, 0x23, 0x24, 0x00, 0x27, 0x28, 0x00,
+    0x00, 0x00, 0x03, 0x27, 0x00, 0x00, 0x17, 0x11, 0x00, 0x03, 0x28, 0x24,
+    0x02, 0x28, 0x24, 0x01, 0x00, 0x26, 0x22, 0x23, 0x02, 0x28, 0x00, 0x00,
+    0x00, 0x24, 0x01, 0x27, 0x00, 0x00, 0x16, 0x00, 0x00, 0x28, 0x14, 0x24,
+    0x18, 0x21, 0x22, 0x15, 0x17, 0x28, 0x00, 0x00, 0x24, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x27, 0x26, 0x24, 0x00, 0x11, 0x00, 0x00, 0x28, 0x24, 0x03,
+    0x02, 0x00, 0x00, 0x11, 0x26, 0x10, 0x05, 0x18, 0x16, 0x24, 0x00, 0x00,
+    0x24, 0x28, 0x00, 0x27, 0x00, 0x28, 0x03, 0x24, 0x24, 0x00, 0x24, 0x00,
+    0x25, 0x00, 0x10, 0x02, 0x28, 0x28, 0x20, 0x28, 0x01, 0x27, 0x28, 0x23,
+    0x10, 0x24, 0x00, 0x24, 0x00, 0x27, 0x24, 0x22, 0x00, 0x00, 0x00, 0x20,
+    0x00, 0x20, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x17, 0x00, 0x11,
+    0x18, 0x24, 0x00, 0x00, 0x22, 0x00, 0x00, 0x21, 0x23, 0x22, 0x00, 0x12,
+    0x10, 0x21, 0x23, 0x27, 0x00, 0x17, 0x23, 0x00, 0x24, 0x00, 0x00, 0x00,
+    0x00, 0x28, 0x28, 0x10, 0x00, 0x00, 0x04, 0x27, 0x22, 0x28, 0x25, 0x10,
+    0x00, 0x00, 0x00, 0x27, 0x00, 0x18, 0x00, 0x00, 0x02, 0x10, 0x24, 0x26,
+    0x23, 0x00, 0x27, 0x24, 0x22, 0x15, 0x00, 0x00, 0x28, 0x18, 0x00, 0x00,
+    0x16, 0x24, 0x00, 0x00, 0x18, 0x00, 0x20, 0x20, 0x28, 0x00, 0x00, 0x27,
+    0x28, 0x18, 0x00, 0x00, 0x14, 0x06, 0x13, 0x25, 0x00, 0x26, 0x12, 0x20,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x03, 0x00, 0x00, 0x04, 0x24, 0x24,
+    0x00, 0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x00, 0x00, 0x28, 0x00,
+    0x00, 0x00, 0x28, 0x04, 0x27, 0x00, 0x21, 0x27, 0x10, 0x23, 0x24, 0x25,
+    0x20, 0x05, 0x28, 0x27, 0x20, 0x00, 0x28, 0x27, 0x02, 0x00, 0x00, 0x00,
+    0x28, 0x24, 0x18, 0x28, 0x22, 0x24, 0x10, 0x21, 0x14, 0x18, 0x21, 0x21,
+    0x00, 0x00, 0x26, 0x27, 0x00, 0x01, 0x00, 0x17, 0x13, 0x00, 0x00, 0x28,
+    0x18, 0x13, 0x24, 0x10, 0x24, 0x22, 0x27, 0x24, 0x14, 0x18, 0x14, 0x02,
+    0x24, 0x28, 0x27, 0x13, 0x00, 0x11, 0x22, 0x00, 0x28, 0x20, 0x10, 0x00,
+    0x00, 0x07, 0x00, 0x14, 0x10, 0x24, 0x22, 0x10, 0x28, 0x27, 0x10, 0x28,
+    0x27, 0x01, 0x27, 0x00, 0x00, 0x00, 0x00, 0x28, 0x24, 0x02, 0x00, 0x00,
+    0x00, 0x20, 0x24, 0x00, 0x00, 0x26, 0x02, 0x28, 0x23, 0x25, 0x00, 0x16,
+    0x16, 0x24, 0x00, 0x00, 0x21, 0x22, 0x00, 0x21, 0x01, 0x28, 0x12, 0x00,
+    0x00, 0x00, 0x26, 0x24, 0x23, 0x06, 0x01, 0x24, 0x17, 0x00, 0x24, 0x00,
+    0x28, 0x00, 0x00, 0x00, 0x23, 0x00, 0x00, 0x00, 0x15, 0x20, 0x24, 0x27,
+    0x00, 0x11, 0x25, 0x00, 0x00, 0x00, 0x22, 0x24, 0x10, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x10, 0x23, 0x28, 0x27, 0x24, 0x00, 0x23, 0x00, 0x27, 0x14,
+    0x00, 0x00, 0x00, 0x24, 0x00, 0x00, 0x00, 0x02, 0x00, 0x28, 0x24, 0x28,
+    0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x24, 0x27,
+    0x00, 0x21, 0x00, 0x00, 0x21, 0x00, 0x13, 0x27, 0x00, 0x00, 0x20, 0x28,
+    0x07, 0x28, 0x11, 0x18, 0x18, 0x03, 0x25, 0x00, 0x00, 0x00, 0x15, 0x24,
+    0x27, 0x02, 0x00, 0x00, 0x24, 0x00, 0x24, 0x00, 0x05, 0x28, 0x00, 0x01,
+    0x20, 0x27, 0x00, 0x18, 0x00, 0x28, 0x00, 0x27, 0x00, 0x00, 0x00, 0x25,
+    0x00, 0x00, 0x18, 0x20, 0x24, 0x17, 0x00, 0x00, 0x00, 0x00, 0x04, 0x11,
+    0x00, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x20, 0x24, 0x00, 0x00, 0x21, 0x28, 0x24, 0x24, 0x27, 0x11,
+    0x07, 0x18, 0x00, 0x13, 0x23, 0x28, 0x00, 0x17, 0x21, 0x00, 0x28, 0x00,
+    0x03, 0x22, 0x28, 0x00, 0x00, 0x00, 0x24, 0x01, 0x00, 0x22, 0x13, 0x23,
+    0x00, 0x14, 0x00, 0x23, 0x22, 0x00, 0x00, 0x28, 0x00, 0x17, 0x28, 0x00,
+    0x10, 0x24, 0x00, 0x00, 0x27, 0x20, 0x24, 0x28, 0x24, 0x28, 0x22, 0x10,
+    0x24, 0x16, 0x22, 0x20, 0x24, 0x02, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x28, 0x00, 0x00, 0x01, 0x10, 0x14, 0x00, 0x25, 0x00, 0x11, 0x11, 0x00,
+    0x24, 0x28, 0x00, 0x20, 0x00, 0x28, 0x00, 0x28, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x22, 0x28, 0x00, 0x21, 0x26, 0x28,
+    0x01, 0x12, 0x00, 0x26, 0x28, 0x00, 0x23, 0x24, 0x00, 0x00, 0x00, 0x00,
+    0x01, 0x00, 0x02, 0x02, 0x24, 0x13, 0x28, 0x24, 0x00, 0x02, 0x20, 0x14,
+    0x28, 0x20, 0x23, 0x28, 0x20, 0x27, 0x24, 0x28, 0x27, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x11, 0x10, 0x22, 0x22, 0x26, 0x00, 0x00, 0x00, 0x01, 0x24,
+    0x18, 0x00, 0x27, 0x00, 0x14, 0x00, 0x18, 0x24, 0x25, 0x00, 0x28, 0x00,
+    0x00, 0x10, 0x24, 0x24, 0x13, 0x00, 0x24, 0x21, 0x18, 0x16, 0x05, 0x11,
+    0x25, 0x28, 0x24, 0x00, 0x00, 0x28, 0x28, 0x22, 0x00, 0x00, 0x00, 0x00,
+    0x10, 0x01, 0x00, 0x21, 0x28, 0x00, 0x00, 0x00, 0x28, 0x11, 0x00, 0x00,
+    0x28, 0x23, 0x28, 0x24, 0x00, 0x00, 0x00, 0x28, 0x28, 0x00, 0x24, 0x10,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0x10, 0x13, 0x28, 0x23, 0x00,
+    0x00, 0x17, 0x05, 0x01, 0x12, 0x18, 0x27, 0x00, 0x12, 0x27, 0x21, 0x00,
+    0x01, 0x28, 0x23, 0x12, 0x00, 0x00, 0x26, 0x06, 0x01, 0x20, 0x20, 0x17,
+    0x00, 0x23, 0x03, 0x14, 0x00, 0x00, 0x21, 0x00, 0x00, 0x28, 0x00, 0x01,
+    0x00, 0x24, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x28, 0x00, 0x03,
+    0x17, 0x01, 0x00, 0x24, 0x20, 0x01, 0x00, 0x00, 0x28, 0x11, 0x00, 0x00,
+    0x10, 0x00, 0x27, 0x00, 0x28, 0x00, 0x00, 0x00, 0x00, 0x23, 0x24, 0x17,
+    0x04, 0x00, 0x00, 0x03, 0x00, 0x28, 0x00, 0x28, 0x00, 0x16, 0x00, 0x26,
+    0x00, 0x18, 0x27, 0x28, 0x28, 0x14, 0x00, 0x28, 0x21, 0x27, 0x00, 0x14,
+    0x00, 0x24, 0x28, 0x00, 0x00, 0x26, 0x10, 0x06, 0x24, 0x00, 0x00, 0x28,
+    0x00, 0x00, 0x14, 0x28, 0x00, 0x18, 0x24, 0x00, 0x00, 0x00, 0x24, 0x01,
+    0x28, 0x20, 0x28, 0x21, 0x28, 0x05, 0x24, 0x13, 0x28, 0x00, 0x00, 0x12,
+    0x28, 0x00, 0x24, 0x00, 0x00, 0x22, 0x28, 0x27, 0x00, 0x00, 0x01, 0x00,
+    0x00, 0x04, 0x01, 0x21, 0x24, 0x24, 0x00, 0x00, 0x05, 0x28, 0x14, 0x24,
+    0x23, 0x28, 0x00, 0x00, 0x24, 0x01, 0x20, 0x02, 0x23, 0x24, 0x14, 0x27,
+    0x00, 0x00, 0x27, 0x14
+};
+
+const PerfectTable perfect3 = {3, 1024, keys, entries, NULL, 0};
@@ -0,0 +1,113 @@
+#include <string.h>
+#include <unistd.h>
+#include "render.h"
+
+// " %2s " for one cell: its number while empty, its symbol once taken
+static char *putCell(const Board *b, int cell, char *p) {
+    int owner = boardOwner(b, cell);
+    *p++ = ' ';
+    if (owner >= 0) {
+        *p++ = ' ';
+        *p++ = playerSymbols[owner];
+    } else {
+        *p++ = cell >= 10 ? (char)('0' + cell / 10) : ' ';
+        *p++ = (char)('0' + cell % 10);
+    }
+    *p++ = ' ';
+    return p;
+}
+
+static char *putNumber(int n, char *p) {
+    if (n >= 10) p = putNumber(n / 10, p);
+    *p++ = (char)('0' + n % 10);
+    return p;
+}
+
+// Cursor to a 1-based row and column
+static char *putMove(int row, int col, char *p) {
+    *p++ = '\033';
+    *p++ = '[';
+    p = putNumber(row, p);
+    *p++ = ';';
+    p = putNumber(col, p);
+    *p++ = 'H';
+    return p;
+}
+
+// Same layout showBoard always printed, built in one buffer; returns the
+// length
+int renderFrame(const Board *b, char *out) {
+    int size = b->size;
+    char *p = out;
+    *p++ = '\n';
+    for (int i = 0; i < size; i++) {
+        memcpy(p, "   ", 3);
+        p += 3;
+        for (int j = 0; j < size; j++) {
+            p = putCell(b, i * size + j, p);
+            if (j < size - 1) *p++ = '|';
+        }
+        *p++ = '\n';
+        if (i < size - 1) {
+            memcpy(p, "   ", 3);
+            p += 3;
+            for (int k = 0; k < size; k++) {
+                memcpy(p, "----", 4);
+                p += 4;
+                if (k < size - 1) *p++ = '+';
+            }
+            *p++ = '\n';
+        }
+    }
+    *p++ = '\n';
+    return (int)(p - out);
+}
+
+void rendererInit(Renderer *r, int fd, int mode) {
+    memset(r, 0, sizeof *r);
+    r->fd = fd;
+    r->mode = mode;
+}
+
+// Bytes that bring the terminal from the last frame to this board. In
+// differential mode the first frame clears the screen and draws the board
+// at the top; after that only changed cells are repainted in place and
+// the cursor is left on a cleared screen just under the board, where the
+// next prompt goes.
+int rendererFrame(Renderer *r, const Board *b, char *out) {
+    char *p = out;
+    Bits changed = 0;
+    if (r->mode == RENDER_FULL)
+        return renderFrame(b, out);
+    if (r->size != b->size) {
+        memcpy(p, "\033[H\033[2J", 7);
+        p += 7;
+        p += renderFrame(b, p);
+    } else {
+        for (int player = 0; player < MAX_PLAYERS; player++)
+            changed |= r->shown[player] ^ b->pieces[player];
+        for (; changed; changed &= changed - 1) {
+            int cell = bitCell(b, bitsFirst(changed));
+            // Frame line 1 is blank, then cell rows alternate with rules
+            p = putMove(2 + 2 * (cell / b->size), 4 + 5 * (cell % b->size), p);
+            p = putCell(b, cell, p);
+        }
+        p = putMove(2 * b->size + 2, 1, p);
+        memcpy(p, "\033[J", 3);
+        p += 3;
+    }
+    r->size = b->size;
+    memcpy(r->shown, b->pieces, sizeof r->shown);
+    return (int)(p - out);
+}
+
+// Build the next frame and hand it to the terminal in a single write
+void rendererDraw(Renderer *r, const Board *b) {
+    char frame[RENDER_MAX_FRAME];
+    int length = rendererFrame(r, b, frame), sent = 0;
+    while (sent < length) {
+        ssize_t n = write(r->fd, frame + sent, length - sent);
+        if (n <= 0) return;
+        sent += (int)n;
+    }
+}
@@ -0,0 +1,29 @@
+#ifndef RENDER_H
+#define RENDER_H
+
+#include "board.h"
+
+// Largest frame renderFrame produces (10x10 is a little over 1 KB); diffs
+// are always smaller
+#define RENDER_MAX_FRAME 2048
+
+#define RENDER_FULL 0      // redraw the whole board every time
+#define RENDER_DIFF 1      // ANSI: repaint only the cells that changed
+
+// Remembers what the terminal on fd was last sent, so a differential
+// redraw knows which cells to touch. One per output terminal.
+typedef struct {
+    int fd;
+    int mode;
+    int size;                    // size of the board on screen, 0 for none yet
+    Bits shown[MAX_PLAYERS];     // pieces as last drawn
+} Renderer;
+
+// The board as shown to players, cells numbered until taken
+int  renderFrame(const Board *b, char *out);
+
+void rendererInit(Renderer *r, int fd, int mode);
+int  rendererFrame(Renderer *r, const Board *b, char *out);
+void rendererDraw(Renderer *r, const Board *b);
+
+#endif
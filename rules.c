@@ -0,0 +1,106 @@
+#include "rules.h"
+
+// The shared bodies are written once, for any size, and only ever called
+// with constant arguments from the instances DEFINE_RULES makes below, so
+// the compiler folds each one down for its size.
+#define ALWAYS_INLINE static inline __attribute__((always_inline))
+
+// Bits that start a run of winLength of mine going in direction d
+ALWAYS_INLINE Bits runStarts(Bits mine, int d, int winLength) {
+    Bits run = mine;
+#pragma GCC unroll 8
+    for (int k = 1; k < winLength; k++)
+        run &= mine >> (d * k);
+    return run;
+}
+
+ALWAYS_INLINE int hasWonFor(const Board *b, int player, int size, int winLength) {
+    const int stride = size + 1, dirs[4] = {1, stride, stride + 1, stride - 1};
+    const Bits mine = b->pieces[player];
+    Bits any = 0;
+#pragma GCC unroll 4
+    for (int d = 0; d < 4; d++)
+        any |= runStarts(mine, dirs[d], winLength);
+    return any != 0;
+}
+
+// The line counts board.c keeps already say how full every line through
+// the cell is; with the size fixed the table and the player's full count
+// are constants.
+ALWAYS_INLINE int winsAtFor(const Board *b, int cell, int player, int size, int winLength) {
+    const LineTable *t = &lineTables[size];
+    const unsigned full = (unsigned)winLength << (4 * player);
+    const unsigned mask = 0xFu << (4 * player);
+    for (int i = 0; i < t->cellCount[cell]; i++)
+        if ((b->lineCounts[t->cellLines[cell][i]] & mask) == full) return 1;
+    return 0;
+}
+
+// For every gap position in a run, the starts where every other cell is
+// mine and the gap is empty; the gap itself is the threat
+ALWAYS_INLINE Bits threatsFor(const Board *b, int player, int size, int winLength) {
+    // Only rows, columns and two diagonals on 3x3 and 4x4: just go through them
+    if (size <= 4) {
+        const Bits mine = b->pieces[player], empty = b->valid & ~b->occupied;
+        Bits threats = 0;
+#pragma GCC unroll 10
+        for (int i = 0; i < 2 * size + 2; i++) {
+            Bits gap = lineTables[size].lines[i] & ~mine;
+            if ((gap & (gap - 1)) == 0) threats |= gap & empty;
+        }
+        return threats;
+    }
+    const int stride = size + 1, dirs[4] = {1, stride, stride + 1, stride - 1};
+    const Bits mine = b->pieces[player], empty = b->valid & ~b->occupied;
+    Bits threats = 0;
+#pragma GCC unroll 4
+    for (int d = 0; d < 4; d++) {
+        Bits shifted[8];
+#pragma GCC unroll 8
+        for (int k = 0; k < winLength; k++)
+            shifted[k] = mine >> (dirs[d] * k);
+#pragma GCC unroll 8
+        for (int gap = 0; gap < winLength; gap++) {
+            Bits starts = empty >> (dirs[d] * gap);
+#pragma GCC unroll 8
+            for (int k = 0; k < winLength; k++)
+                if (k != gap) starts &= shifted[k];
+            threats |= starts << (dirs[d] * gap);
+        }
+    }
+    return threats;
+}
+
+#define DEFINE_RULES(size)                                                      \
+    static int hasWon##size(const Board *b, int player) {                       \
+        return hasWonFor(b, player, size, boardWinLengthFor(size));             \
+    }                                                                           \
+    static int winsAt##size(const Board *b, int cell, int player) {             \
+        return winsAtFor(b, cell, player, size, boardWinLengthFor(size));       \
+    }                                                                           \
+    static Bits threats##size(const Board *b, int player) {                     \
+        return threatsFor(b, player, size, boardWinLengthFor(size));            \
+    }                                                                           \
+    static const Rules rules##size = {size, hasWon##size, winsAt##size, threats##size};
+
+// boardWinLength as a constant expression
+#define boardWinLengthFor(size) ((size) >= 4 ? 4 : (size))
+
+DEFINE_RULES(3)
+DEFINE_RULES(4)
+DEFINE_RULES(5)
+DEFINE_RULES(7)
+DEFINE_RULES(10)
+
+const Rules genericRules = {0, boardHasWon, boardWinsAt, boardThreats};
+
+const Rules *rulesFor(int size) {
+    switch (size) {
+    case 3: return &rules3;
+    case 4: return &rules4;
+    case 5: return &rules5;
+    case 7: return &rules7;
+    case 10: return &rules10;
+    default: return &genericRules;
+    }
+}
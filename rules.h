@@ -0,0 +1,24 @@
+#ifndef RULES_H
+#define RULES_H
+
+#include "board.h"
+
+// The win rules for one board size. The common sizes (3, 4, 5, 7 and 10)
+// each get their own copy of these functions with the size, stride and
+// win length compiled in, so every shift is a constant and every loop
+// over directions and run lengths is unrolled. Any other size gets the
+// generic board.c functions. The results are always the same as
+// board.c's; only the speed differs.
+typedef struct {
+    int size;                     // 0 for the generic rules
+    int  (*hasWon)(const Board *b, int player);
+    int  (*winsAt)(const Board *b, int cell, int player);
+    Bits (*threats)(const Board *b, int player);
+} Rules;
+
+extern const Rules genericRules;
+
+// The specialized rules for size if there are any, else genericRules
+const Rules *rulesFor(int size);
+
+#endif
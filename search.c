@@ -0,0 +1,290 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "search.h"
+#include "rules.h"
+#include "pattern.h"
+
+#define INF (SEARCH_WIN + 1)
+#define WIN_BOUND (SEARCH_WIN - MAX_CELLS)   // anything above is a forced win
+
+// Keyed by the player to move rather than the side, so what one player's
+// search leaves in the table still fits when the other one searches
+static const uint64_t sideKeys[MAX_PLAYERS] = {
+    0, 0xD1B54A32D192ED03ULL, 0x8CB92BA72F3D8DD7ULL,
+};
+
+int searchInit(Search *s, const SearchConfig *config) {
+    memset(s, 0, sizeof *s);
+    s->config = *config;
+    if (s->config.threads < 1) s->config.threads = 1;
+    s->table = &s->tt;
+    s->abort = &s->abortFlag;
+    if (s->config.threads > 1) {
+        s->helpers = calloc(s->config.threads - 1, sizeof(Search));
+        if (!s->helpers) return 0;
+    }
+    return ttInit(&s->tt, config->ttBytes);
+}
+
+void searchFree(Search *s) {
+    ttFree(&s->tt);
+    free(s->helpers);
+    s->helpers = NULL;
+}
+
+// Small boards can be searched to the end; larger ones get a horizon
+int searchDefaultDepth(int size) {
+    if (size == 3) return 9;
+    if (size == 4) return 8;
+    return 6;
+}
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Score every segment nobody else has blocked, by how full it is
+static int evaluate(const Board *b, int me) {
+    const int players = (me == 2 || b->pieces[2]) ? 3 : 2;
+    Patterns p;
+    patternCount(b, players, &p);
+    return patternScore(&p, me, players);
+}
+
+// Candidate moves, best guess first: the last iteration's line, the
+// table's move, then by history
+static int orderMoves(const Search *s, const Board *b, int me, int pvMove, int ttMove, int *moves) {
+    int keys[MAX_CELLS], n = 0;
+    Bits cand = boardCandidates(b);
+    if (b->occupied == 0)
+        cand = cellMask(b, (b->size / 2) * b->size + b->size / 2);
+    while (cand) {
+        int bit = bitsFirst(cand), cell = bitCell(b, bit);
+        int key = (cell == pvMove) ? 1 << 30
+                : (cell == ttMove) ? 1 << 29
+                : s->history[me][cell];
+        int i = n++;
+        cand &= cand - 1;
+        while (i > 0 && keys[i - 1] < key) {
+            keys[i] = keys[i - 1];
+            moves[i] = moves[i - 1];
+            i--;
+        }
+        keys[i] = key;
+        moves[i] = cell;
+    }
+    return n;
+}
+
+// Wins are stored relative to the node so they stay valid at any ply
+static int toTT(int score, int ply) {
+    if (score > WIN_BOUND) return score + ply;
+    if (score < -WIN_BOUND) return score - ply;
+    return score;
+}
+
+static int fromTT(int score, int ply) {
+    if (score > WIN_BOUND) return score - ply;
+    if (score < -WIN_BOUND) return score + ply;
+    return score;
+}
+
+static int negamax(Search *s, Board *b, int depth, int ply, int alpha, int beta, int side) {
+    const int me = s->players[side];
+    const int alphaOrig = alpha;
+    int moves[MAX_CELLS], n, best = -INF, bestMove = -1, ttMove = -1, pvMove = -1;
+    uint64_t key;
+    TTHit hit;
+    // Positions share entries with their rotations and reflections; the
+    // stored move is in the canonical form's orientation
+    const int symmetry = boardCanonical(b, &key);
+    key ^= sideKeys[me];
+
+    s->pvLength[ply] = 0;
+    if ((++s->nodes & 1023) == 0 &&
+        ((s->deadline > 0 && nowSeconds() > s->deadline) ||
+         __atomic_load_n(s->abort, __ATOMIC_RELAXED)))
+        s->stopped = 1;
+    if (s->stopped) return 0;
+
+    if (ttProbe(s->table, key, &hit)) {
+        if (hit.move >= 0)
+            ttMove = symmetryCell(b->size, symmetryInverse[symmetry], hit.move);
+        if (hit.depth >= depth && ply > 0) {
+            int score = fromTT(hit.score, ply);
+            if (hit.bound == TT_EXACT ||
+                (hit.bound == TT_LOWER && score >= beta) ||
+                (hit.bound == TT_UPPER && score <= alpha))
+                return score;
+        }
+    }
+    if (depth == 0)
+        return evaluate(b, me);
+
+    if (s->followPv && ply < s->prevPvLength)
+        pvMove = s->prevPv[ply];
+    else
+        s->followPv = 0;
+
+    n = orderMoves(s, b, me, pvMove, ttMove, moves);
+    for (int i = 0; i < n; i++) {
+        int score;
+        if (moves[i] != pvMove) s->followPv = 0;
+        boardPlace(b, moves[i], me);
+        if (boardWinsAt(b, moves[i], me)) {
+            score = SEARCH_WIN - ply - 1;
+            s->pvLength[ply + 1] = 0;
+        } else if (boardIsDrawn(b)) {
+            score = 0;
+            s->pvLength[ply + 1] = 0;
+        } else {
+            score = -negamax(s, b, depth - 1, ply + 1, -beta, -alpha, side ^ 1);
+        }
+        boardRemove(b, moves[i], me);
+        if (s->stopped) return 0;
+
+        if (score > best) {
+            best = score;
+            bestMove = moves[i];
+            s->pv[ply][0] = (unsigned char)moves[i];
+            memcpy(&s->pv[ply][1], s->pv[ply + 1], s->pvLength[ply + 1]);
+            s->pvLength[ply] = s->pvLength[ply + 1] + 1;
+        }
+        if (score > alpha) alpha = score;
+        if (alpha >= beta) {
+            s->history[me][moves[i]] += depth * depth;
+            break;
+        }
+    }
+
+    ttStore(s->table, key, toTT(best, ply), depth,
+            best <= alphaOrig ? TT_UPPER : best >= beta ? TT_LOWER : TT_EXACT,
+            bestMove < 0 ? -1 : symmetryCell(b->size, symmetry, bestMove));
+    return best;
+}
+
+// A helper keeps deepening until it runs out of depth or is told to stop;
+// its results only reach the main search through the table.
+static void *helperMain(void *arg) {
+    Search *h = arg;
+    for (int depth = 1 + (h->threadId & 1); depth <= h->depthLimit; depth++) {
+        h->followPv = 0;
+        negamax(h, &h->board, depth, 0, -INF, INF, 0);
+        if (h->stopped) break;
+    }
+    return NULL;
+}
+
+// Start the helpers on a copy of the position; returns how many started
+static int startHelpers(Search *s, const Board *b, int limit, pthread_t *threads) {
+    int started = 0;
+    s->abortFlag = 0;
+    for (int i = 0; i < s->config.threads - 1; i++) {
+        Search *h = &s->helpers[i];
+        h->config = s->config;
+        h->table = s->table;
+        h->abort = &s->abortFlag;
+        h->threadId = i + 1;
+        h->board = *b;
+        h->depthLimit = limit;
+        h->players[0] = s->players[0];
+        h->players[1] = s->players[1];
+        h->nodes = 0;
+        h->stopped = 0;
+        h->deadline = 0;
+        h->prevPvLength = 0;
+        if (pthread_create(&threads[started], NULL, helperMain, h) != 0) break;
+        started++;
+    }
+    return started;
+}
+
+static void stopHelpers(Search *s, int started, pthread_t *threads) {
+    __atomic_store_n(&s->abortFlag, 1, __ATOMIC_RELAXED);
+    for (int i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+        s->nodes += s->helpers[i].nodes;
+    }
+}
+
+// Search the position for player to move and return the chosen cell.
+// Each iteration starts from the previous one's best line; with a time
+// budget the answer is the best move of the deepest iteration that
+// finished. The board is left exactly as it was passed in.
+int searchBestMove(Search *s, Board *b, int player, int opponent, SearchResult *result) {
+    int limit = s->config.maxDepth;
+    int move = b->freeCells[0], score = 0, completed = 0, started = 0;
+    double start = nowSeconds();
+    pthread_t threads[s->config.threads];
+    Bits wins = rulesFor(b->size)->threats(b, player);
+
+    // A win on the spot needs no search
+    if (wins) {
+        move = bitCell(b, bitsFirst(wins));
+        if (result) {
+            result->move = move;
+            result->score = SEARCH_WIN - 1;
+            result->depth = 1;
+            result->nodes = 0;
+        }
+        return move;
+    }
+    if (limit == 0)
+        limit = s->config.timeMs ? b->freeCount : searchDefaultDepth(b->size);
+    if (limit > b->freeCount) limit = b->freeCount;
+    s->players[0] = player;
+    s->players[1] = opponent;
+    s->nodes = 0;
+    s->stopped = 0;
+    s->prevPvLength = 0;
+    s->deadline = 0;
+    s->abortFlag = 0;
+    if (s->helpers)
+        started = startHelpers(s, b, limit, threads);
+
+    for (int depth = 1; depth <= limit; depth++) {
+        int value;
+        s->followPv = 1;
+        value = negamax(s, b, depth, 0, -INF, INF, 0);
+        if (s->stopped) break;
+
+        score = value;
+        completed = depth;
+        s->prevPvLength = s->pvLength[0];
+        memcpy(s->prevPv, s->pv[0], s->pvLength[0]);
+        if (s->pvLength[0] > 0) move = s->prevPv[0];
+
+        // The clock only starts once depth 1 is in, so there is always a move
+        if (depth == 1 && s->config.timeMs)
+            s->deadline = start + s->config.timeMs / 1000.0;
+        if (score > WIN_BOUND || score < -WIN_BOUND) break;
+    }
+    if (s->helpers)
+        stopHelpers(s, started, threads);
+
+    if (result) {
+        result->move = move;
+        result->score = score;
+        result->depth = completed;
+        result->nodes = s->nodes;
+    }
+    return move;
+}
+
+// Search as player until *stop turns nonzero, with no depth or time limit
+// of its own. Used while waiting for player to move: the opponent's search
+// that follows finds the replies to most moves already in the table.
+void searchPonder(Search *s, Board *b, int player, int opponent, int *stop) {
+    const SearchConfig config = s->config;
+    s->config.maxDepth = MAX_CELLS;
+    s->config.timeMs = 0;
+    s->abort = stop;
+    searchBestMove(s, b, player, opponent, NULL);
+    s->abort = &s->abortFlag;
+    s->config = config;
+}
@@ -0,0 +1,63 @@
+#ifndef SEARCH_H
+#define SEARCH_H
+
+#include <stddef.h>
+#include "board.h"
+#include "tt.h"
+
+#define SEARCH_WIN 30000          // score of a win on the next move
+
+typedef struct {
+    int maxDepth;                 // plies to look ahead, 0 picks one from the board size
+    size_t ttBytes;               // transposition table budget
+    int timeMs;                   // per-move wall-clock budget, 0 for none
+    int threads;                  // search threads sharing the table, 0 or 1 for one
+} SearchConfig;
+
+typedef struct {
+    int move;
+    int score;                    // from the mover's point of view
+    int depth;                    // last depth that finished
+    long long nodes;
+} SearchResult;
+
+// Negamax alpha-beta searcher, deepened one ply at a time until the depth
+// limit or the time budget runs out. The transposition table and the move
+// ordering history carry over from one move to the next.
+//
+// With more than one thread the extra ones are Lazy SMP helpers: each
+// searches its own copy of the board, half of them one ply deeper, and
+// they only talk to the main search through the shared table.
+typedef struct Search {
+    SearchConfig config;
+    TransTable tt;                // owned by the main search
+    TransTable *table;            // the table actually probed
+    struct Search *helpers;       // config.threads - 1 helper searches
+    int threadId;                 // 0 for the main search
+    int abortFlag;                // main search sets it to stop the helpers
+    int *abort;                   // main search's abortFlag, or the ponder's stop flag
+    Board board;                  // a helper's private copy of the position
+    int depthLimit;
+
+    int players[2];               // side to move, then the opponent
+    long long nodes;
+    int history[MAX_PLAYERS][MAX_CELLS];
+
+    double deadline;              // seconds on the monotonic clock
+    int stopped;                  // ran out of time mid-iteration
+
+    // principal variation: being built, and from the last finished depth
+    int pvLength[MAX_CELLS + 1];
+    unsigned char pv[MAX_CELLS + 1][MAX_CELLS];
+    int prevPvLength;
+    unsigned char prevPv[MAX_CELLS];
+    int followPv;
+} Search;
+
+int  searchInit(Search *s, const SearchConfig *config);
+void searchFree(Search *s);
+int  searchDefaultDepth(int size);
+int  searchBestMove(Search *s, Board *b, int player, int opponent, SearchResult *result);
+void searchPonder(Search *s, Board *b, int player, int opponent, int *stop);
+
+#endif
@@ -0,0 +1,605 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "game.h"
+#include "search.h"
+#include "mcts.h"
+#include "perfect.h"
+
+// Game server: one epoll loop owns every connection and every game; the
+// computer's moves are worked out by a pool of threads so a slow search
+// never holds up other sessions.
+//
+//   gcc -O2 -o server server.c game.c render.c movelog.c board.c rules.c pattern.c tt.c search.c mcts.c perfect.c perfect3.c -lpthread -lm
+//   ./server -p 7777 -u /tmp/tictactoe.sock -w 8
+//
+// Line protocol, one command per line, any number of games per connection:
+//
+//   NEW <size> <mode> [computers]   mode 1, 2 or 3; computers lists the
+//                                   computer symbols (mode 2 means "O")
+//   MOVE <game> <cell>              play for the side to move
+//   BOARD <game>                    ask for the board
+//   QUIT <game>                     abandon a game
+//
+// Replies: OK <game> <size> <players>, MOVED <game> <symbol> <cell>,
+// TURN <game> <symbol>, WIN <game> <symbol>, DRAW <game>,
+// BOARD <game> <cells as . X O Z>, ERR <game or -> <reason>. Game ids
+// are never reused while the server runs.
+
+#define MAX_EVENTS 256
+#define LINE_MAX_LEN 128
+#define MAX_OUT (256 << 10)        // unread replies a client may leave before it's dropped
+
+typedef struct Conn {
+    int fd;
+    char in[4096];
+    size_t inLen;
+    char *out;
+    size_t outStart, outLen, outCap;  // out[outStart, outLen) is still to be written
+    int firstSession;              // sessions hosted on this connection
+    int dead;                      // closes once the current batch of events is done
+    struct Conn *nextDead;
+} Conn;
+
+typedef struct {
+    Game game;
+    int conn;                      // fd of the owning connection
+    unsigned generation;           // bumped on release, so stale AI answers are dropped
+    unsigned char isComputer[MAX_PLAYERS];
+    unsigned char inUse;
+    unsigned char thinking;        // a computer move is with the workers
+    int prev, next;                // the owning connection's session list
+} Session;
+
+typedef struct {
+    int session;
+    unsigned generation;
+    int player;
+    int players;
+    int move;                      // filled in by the worker
+    Board board;
+} Job;
+
+typedef struct {
+    Job *items;
+    size_t cap, head, count;
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+} JobQueue;
+
+static Conn **conns;               // by fd
+static Conn *deadConns;            // to close after this batch of events
+static int maxConns;
+static Session *sessions;
+static int maxSessions;
+static int *freeSessions, freeSessionCount;
+static int epfd, wakeFd;
+
+static JobQueue pending, done;
+static SearchConfig searchConfig = {0, 8 << 20, 20, 1};
+static MctsConfig mctsConfig = {0, 20, 1, 1 << 18, 0};
+static PerfectTable perfect4;      // from perfect4.tbl, if solve has written one
+
+static int queueInit(JobQueue *q, size_t cap) {
+    if (cap < 16) cap = 16;
+    q->items = malloc(cap * sizeof(Job));
+    q->cap = cap;
+    q->head = q->count = 0;
+    pthread_mutex_init(&q->lock, NULL);
+    pthread_cond_init(&q->ready, NULL);
+    return q->items != NULL;
+}
+
+// Grows when full: a game abandoned mid-search can be reused while its
+// old job is still queued, so sessions don't strictly bound the jobs
+static void queuePush(JobQueue *q, const Job *job) {
+    pthread_mutex_lock(&q->lock);
+    if (q->count == q->cap) {
+        Job *items = malloc(q->cap * 2 * sizeof(Job));
+        if (!items) {
+            fprintf(stderr, "Out of memory.\n");
+            exit(1);
+        }
+        for (size_t i = 0; i < q->count; i++)
+            items[i] = q->items[(q->head + i) % q->cap];
+        free(q->items);
+        q->items = items;
+        q->head = 0;
+        q->cap *= 2;
+    }
+    q->items[(q->head + q->count++) % q->cap] = *job;
+    pthread_cond_signal(&q->ready);
+    pthread_mutex_unlock(&q->lock);
+}
+
+static void queuePopWait(JobQueue *q, Job *job) {
+    pthread_mutex_lock(&q->lock);
+    while (q->count == 0)
+        pthread_cond_wait(&q->ready, &q->lock);
+    *job = q->items[q->head];
+    q->head = (q->head + 1) % q->cap;
+    q->count--;
+    pthread_mutex_unlock(&q->lock);
+}
+
+static int queueTryPop(JobQueue *q, Job *job) {
+    int got = 0;
+    pthread_mutex_lock(&q->lock);
+    if (q->count) {
+        *job = q->items[q->head];
+        q->head = (q->head + 1) % q->cap;
+        q->count--;
+        got = 1;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return got;
+}
+
+// Each worker has its own search table and tree; jobs carry a copy of
+// the board, so workers never touch live game state
+static void *workerMain(void *arg) {
+    Search search;
+    Mcts mcts;
+    (void)arg;
+    if (!searchInit(&search, &searchConfig) || !mctsInit(&mcts, &mctsConfig)) {
+        fprintf(stderr, "worker: out of memory\n");
+        exit(1);
+    }
+    while (1) {
+        Job job;
+        uint64_t one = 1;
+        queuePopWait(&pending, &job);
+        if (job.players == 2) {
+            job.move = perfectMove(job.board.size == 3 ? &perfect3 : &perfect4,
+                                   &job.board, job.player, 1 - job.player, NULL);
+            if (job.move < 0)
+                job.move = searchBestMove(&search, &job.board, job.player, 1 - job.player, NULL);
+        } else
+            job.move = mctsBestMove(&mcts, &job.board, job.player, job.players, NULL);
+        queuePush(&done, &job);
+        if (write(wakeFd, &one, sizeof one) < 0) perror("eventfd");
+    }
+    return NULL;
+}
+
+static void setNonBlocking(int fd) {
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+}
+
+static void watch(int fd, uint32_t events, int add) {
+    struct epoll_event ev = {0};
+    ev.events = events;
+    ev.data.fd = fd;
+    epoll_ctl(epfd, add ? EPOLL_CTL_ADD : EPOLL_CTL_MOD, fd, &ev);
+}
+
+// Close a connection once the current batch of events is done. Until
+// then its fd stays open, so accept can't hand the number to a new
+// client that a stale event later in the batch would reach.
+static void dropConn(Conn *c) {
+    if (c->dead) return;
+    c->dead = 1;
+    c->nextDead = deadConns;
+    deadConns = c;
+}
+
+// Queue a reply; it goes out when the socket is writable. A client that
+// lets MAX_OUT of them pile up unread, or one we can't find memory for,
+// is dropped rather than allowed to take the server down.
+static void sendLine(Conn *c, const char *fmt, ...) {
+    char line[LINE_MAX_LEN + MAX_CELLS];
+    va_list args;
+    int n;
+    va_start(args, fmt);
+    n = vsnprintf(line, sizeof line, fmt, args);
+    va_end(args);
+    if (n < 0 || c->dead) return;
+    if (c->outLen - c->outStart + n > MAX_OUT) {
+        dropConn(c);
+        return;
+    }
+    // Out of room: move the unwritten part to the front before growing
+    if (c->outLen + n > c->outCap && c->outStart > 0) {
+        memmove(c->out, c->out + c->outStart, c->outLen - c->outStart);
+        c->outLen -= c->outStart;
+        c->outStart = 0;
+    }
+    if (c->outLen + n > c->outCap) {
+        size_t cap = c->outCap ? c->outCap * 2 : 4096;
+        char *grown;
+        while (cap < c->outLen + n) cap *= 2;
+        if (!(grown = realloc(c->out, cap))) {
+            dropConn(c);
+            return;
+        }
+        c->out = grown;
+        c->outCap = cap;
+    }
+    if (c->outLen == 0) watch(c->fd, EPOLLIN | EPOLLOUT, 0);
+    memcpy(c->out + c->outLen, line, n);
+    c->outLen += n;
+}
+
+// Public game ids fold in the slot's generation, so an id from a finished
+// game never reaches the game that reuses its slot
+static long long gameId(int slot) {
+    return (long long)sessions[slot].generation * maxSessions + slot;
+}
+
+// Slot for a client's game id, or -1 if it isn't a live game of theirs
+static int lookupSession(Conn *c, long long id) {
+    int slot;
+    if (id < 0) return -1;
+    slot = (int)(id % maxSessions);
+    if (!sessions[slot].inUse || sessions[slot].conn != c->fd ||
+        sessions[slot].generation != (unsigned)(id / maxSessions))
+        return -1;
+    return slot;
+}
+
+static void releaseSession(int slot) {
+    Session *s = &sessions[slot];
+    Conn *c = conns[s->conn];
+    if (s->prev >= 0) sessions[s->prev].next = s->next;
+    else c->firstSession = s->next;
+    if (s->next >= 0) sessions[s->next].prev = s->prev;
+    s->inUse = 0;
+    s->generation++;
+    freeSessions[freeSessionCount++] = slot;
+}
+
+// Tell the client what happens next: game over, a human's turn, or hand
+// the move to the workers
+static void advance(int slot) {
+    Session *s = &sessions[slot];
+    Conn *c = conns[s->conn];
+    Game *g = &s->game;
+    if (g->result == GAME_DRAW) {
+        sendLine(c, "DRAW %lld\n", gameId(slot));
+        releaseSession(slot);
+    } else if (g->result != GAME_PLAYING) {
+        sendLine(c, "WIN %lld %c\n", gameId(slot), playerSymbols[g->result]);
+        releaseSession(slot);
+    } else if (s->isComputer[g->toMove]) {
+        Job job;
+        job.session = slot;
+        job.generation = s->generation;
+        job.player = g->toMove;
+        job.players = g->players;
+        job.board = g->board;
+        s->thinking = 1;
+        queuePush(&pending, &job);
+    } else {
+        sendLine(c, "TURN %lld %c\n", gameId(slot), playerSymbols[g->toMove]);
+    }
+}
+
+static void commandNew(Conn *c, const char *args) {
+    int size, mode, slot;
+    char computers[8] = "";
+    Session *s;
+    if (sscanf(args, "%d %d %7s", &size, &mode, computers) < 2 ||
+        size < MIN_SIZE || size > MAX_SIZE || mode < 1 || mode > 3) {
+        sendLine(c, "ERR - bad NEW\n");
+        return;
+    }
+    if (freeSessionCount == 0) {
+        sendLine(c, "ERR - server full\n");
+        return;
+    }
+    slot = freeSessions[--freeSessionCount];
+    s = &sessions[slot];
+    gameInit(&s->game, size, (mode == 3) ? 3 : 2, NULL);
+    memset(s->isComputer, 0, sizeof s->isComputer);
+    if (mode == 2 && computers[0] == '\0') strcpy(computers, "O");
+    for (char *p = computers; *p; p++) {
+        int player = symbolIndex(*p);
+        if (player >= 0 && player < s->game.players) s->isComputer[player] = 1;
+    }
+    s->conn = c->fd;
+    s->inUse = 1;
+    s->thinking = 0;
+    s->prev = -1;
+    s->next = c->firstSession;
+    if (s->next >= 0) sessions[s->next].prev = slot;
+    c->firstSession = slot;
+    sendLine(c, "OK %lld %d %d\n", gameId(slot), size, s->game.players);
+    advance(slot);
+}
+
+static void commandMove(Conn *c, const char *args) {
+    long long id;
+    int slot, cell, player;
+    Session *s;
+    if (sscanf(args, "%lld %d", &id, &cell) != 2 || (slot = lookupSession(c, id)) < 0) {
+        sendLine(c, "ERR - bad MOVE\n");
+        return;
+    }
+    s = &sessions[slot];
+    player = s->game.toMove;
+    if (s->thinking || s->isComputer[player]) {
+        sendLine(c, "ERR %lld not your turn\n", id);
+        return;
+    }
+    switch (gamePlay(&s->game, cell)) {
+    case MOVE_OK:
+        sendLine(c, "MOVED %lld %c %d\n", id, playerSymbols[player], cell);
+        advance(slot);
+        break;
+    case MOVE_OUT_OF_RANGE:
+        sendLine(c, "ERR %lld invalid cell\n", id);
+        break;
+    default:
+        sendLine(c, "ERR %lld cell taken\n", id);
+        break;
+    }
+}
+
+static void commandBoard(Conn *c, const char *args) {
+    char cells[MAX_CELLS + 1];
+    long long id;
+    int slot, n;
+    const Board *b;
+    if (sscanf(args, "%lld", &id) != 1 || (slot = lookupSession(c, id)) < 0) {
+        sendLine(c, "ERR - bad BOARD\n");
+        return;
+    }
+    b = &sessions[slot].game.board;
+    n = b->size * b->size;
+    for (int cell = 0; cell < n; cell++) {
+        int owner = boardOwner(b, cell);
+        cells[cell] = owner < 0 ? '.' : playerSymbols[owner];
+    }
+    cells[n] = '\0';
+    sendLine(c, "BOARD %lld %s\n", id, cells);
+}
+
+static void handleLine(Conn *c, char *line) {
+    if (strncmp(line, "MOVE ", 5) == 0) commandMove(c, line + 5);
+    else if (strncmp(line, "NEW ", 4) == 0) commandNew(c, line + 4);
+    else if (strncmp(line, "BOARD ", 6) == 0) commandBoard(c, line + 6);
+    else if (strncmp(line, "QUIT ", 5) == 0) {
+        long long id;
+        int slot;
+        if (sscanf(line + 5, "%lld", &id) == 1 && (slot = lookupSession(c, id)) >= 0)
+            releaseSession(slot);
+        else
+            sendLine(c, "ERR - bad QUIT\n");
+    }
+    else if (line[0] != '\0') sendLine(c, "ERR - unknown command\n");
+}
+
+static void closeConn(Conn *c) {
+    while (c->firstSession >= 0)
+        releaseSession(c->firstSession);
+    epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    conns[c->fd] = NULL;
+    free(c->out);
+    free(c);
+}
+
+static void acceptAll(int listenFd) {
+    while (1) {
+        int fd = accept(listenFd, NULL, NULL), one = 1;
+        Conn *c;
+        if (fd < 0) return;
+        if (fd >= maxConns || !(c = calloc(1, sizeof *c))) {
+            close(fd);
+            continue;
+        }
+        setNonBlocking(fd);
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof one);
+        c->fd = fd;
+        c->firstSession = -1;
+        conns[fd] = c;
+        watch(fd, EPOLLIN, 1);
+    }
+}
+
+// Returns 0 once the connection has gone away or been dropped
+static int readConn(Conn *c) {
+    while (!c->dead) {
+        ssize_t n = read(c->fd, c->in + c->inLen, sizeof c->in - c->inLen);
+        char *start = c->in, *nl;
+        if (n == 0) return 0;
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        c->inLen += n;
+        while (!c->dead && (nl = memchr(start, '\n', c->in + c->inLen - start))) {
+            *nl = '\0';
+            if (nl > start && nl[-1] == '\r') nl[-1] = '\0';
+            handleLine(c, start);
+            start = nl + 1;
+        }
+        c->inLen -= start - c->in;
+        memmove(c->in, start, c->inLen);
+        if (c->inLen == sizeof c->in) return 0;   // a line that long isn't ours
+    }
+    return 0;
+}
+
+// Write what the socket takes; the buffer only starts over once it's empty
+static int flushConn(Conn *c) {
+    while (c->outStart < c->outLen) {
+        ssize_t n = write(c->fd, c->out + c->outStart, c->outLen - c->outStart);
+        if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK;
+        c->outStart += n;
+    }
+    c->outStart = c->outLen = 0;
+    watch(c->fd, EPOLLIN, 0);
+    return 1;
+}
+
+// Apply the moves the workers have finished
+static void drainDone(void) {
+    uint64_t count;
+    Job job;
+    if (read(wakeFd, &count, sizeof count) < 0) return;
+    while (queueTryPop(&done, &job)) {
+        Session *s = &sessions[job.session];
+        if (!s->inUse || s->generation != job.generation) continue;
+        s->thinking = 0;
+        gamePlay(&s->game, job.move);
+        sendLine(conns[s->conn], "MOVED %lld %c %d\n", gameId(job.session),
+                 playerSymbols[job.player], job.move);
+        advance(job.session);
+    }
+}
+
+static int listenTcp(int port) {
+    struct sockaddr_in addr = {0};
+    int fd = socket(AF_INET, SOCK_STREAM, 0), one = 1;
+    if (fd < 0) return -1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof one);
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons((uint16_t)port);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof addr) < 0 || listen(fd, 1024) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static int listenUnix(const char *path) {
+    struct sockaddr_un addr = {0};
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) return -1;
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, path, sizeof addr.sun_path - 1);
+    unlink(path);
+    if (bind(fd, (struct sockaddr *)&addr, sizeof addr) < 0 || listen(fd, 1024) < 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [-p tcp port] [-u unix socket] [-w workers] [-g max games]\n"
+            "          [-t ms per computer move] [-m table MB per worker]\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    int port = 0, workers = 4, opt, listeners[2], listenerCount = 0;
+    const char *unixPath = NULL;
+    struct rlimit limit;
+    struct epoll_event events[MAX_EVENTS];
+
+    maxSessions = 100000;
+    while ((opt = getopt(argc, argv, "p:u:w:g:t:m:")) != -1) {
+        switch (opt) {
+        case 'p': port = atoi(optarg); break;
+        case 'u': unixPath = optarg; break;
+        case 'w': workers = atoi(optarg); break;
+        case 'g': maxSessions = atoi(optarg); break;
+        case 't': searchConfig.timeMs = mctsConfig.timeMs = atoi(optarg); break;
+        case 'm':
+            searchConfig.ttBytes = (size_t)atoi(optarg) << 20;
+            mctsConfig.maxNodes = searchConfig.ttBytes / (2 * sizeof(MctsNode));
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if ((!port && !unixPath) || workers < 1 || maxSessions < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    // One fd per connection; take as many as we're allowed
+    getrlimit(RLIMIT_NOFILE, &limit);
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    getrlimit(RLIMIT_NOFILE, &limit);
+    maxConns = limit.rlim_cur > 1 << 20 ? 1 << 20 : (int)limit.rlim_cur;
+
+    conns = calloc(maxConns, sizeof *conns);
+    sessions = calloc(maxSessions, sizeof *sessions);
+    freeSessions = malloc(maxSessions * sizeof *freeSessions);
+    if (!conns || !sessions || !freeSessions ||
+        !queueInit(&pending, maxSessions) || !queueInit(&done, maxSessions)) {
+        fprintf(stderr, "Out of memory.\n");
+        return 1;
+    }
+    for (int i = maxSessions - 1; i >= 0; i--)
+        freeSessions[freeSessionCount++] = i;
+    perfectLoad(&perfect4, "perfect4.tbl");
+
+    epfd = epoll_create1(0);
+    wakeFd = eventfd(0, EFD_NONBLOCK);
+    watch(wakeFd, EPOLLIN, 1);
+    if (port && (listeners[listenerCount++] = listenTcp(port)) < 0) {
+        perror("tcp listen");
+        return 1;
+    }
+    if (unixPath && (listeners[listenerCount++] = listenUnix(unixPath)) < 0) {
+        perror("unix listen");
+        return 1;
+    }
+    for (int i = 0; i < listenerCount; i++) {
+        setNonBlocking(listeners[i]);
+        watch(listeners[i], EPOLLIN, 1);
+    }
+
+    for (int i = 0; i < workers; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, workerMain, NULL) != 0) {
+            fprintf(stderr, "Couldn't start worker %d.\n", i);
+            return 1;
+        }
+        pthread_detach(thread);
+    }
+    if (port) printf("Listening on tcp port %d\n", port);
+    if (unixPath) printf("Listening on %s\n", unixPath);
+    printf("%d workers, up to %d games\n", workers, maxSessions);
+    fflush(stdout);
+
+    while (1) {
+        int n = epoll_wait(epfd, events, MAX_EVENTS, -1);
+        for (int i = 0; i < n; i++) {
+            int fd = events[i].data.fd, isListener = 0;
+            Conn *c;
+            for (int l = 0; l < listenerCount; l++)
+                if (fd == listeners[l]) isListener = 1;
+            if (isListener) {
+                acceptAll(fd);
+                continue;
+            }
+            if (fd == wakeFd) {
+                drainDone();
+                continue;
+            }
+            if (!(c = conns[fd]) || c->dead) continue;
+            if ((events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR)) && !readConn(c)) {
+                dropConn(c);
+                continue;
+            }
+            if ((events[i].events & EPOLLOUT) && !flushConn(c))
+                dropConn(c);
+        }
+        while (deadConns) {
+            Conn *c = deadConns;
+            deadConns = c->nextDead;
+            closeConn(c);
+        }
+    }
+}
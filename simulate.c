@@ -0,0 +1,271 @@
+#define _POSIX_C_SOURCE 200809L
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "board.h"
+#include "search.h"
+#include "mcts.h"
+#include "multi.h"
+
+// Headless self-play: no prompts, no board printing, no log file. Games
+// are split evenly across threads and the totals printed at the end.
+//
+//   gcc -O2 -o simulate simulate.c board.c rules.c pattern.c tt.c search.c mcts.c multi.c -lpthread -lm
+//   ./simulate -n 1000000 -s 10 -p random,random,random
+
+typedef enum { PLAYER_RANDOM, PLAYER_SEARCH, PLAYER_MCTS, PLAYER_MAXN, PLAYER_PARANOID } PlayerKind;
+
+typedef struct {
+    int size;
+    int players;                 // 2 or 3
+    PlayerKind kinds[MAX_PLAYERS];
+    long long games;
+    int threads;
+    int randomPlies;             // random opening moves before the players take over
+    SearchConfig search;
+    MctsConfig mcts;
+    MultiConfig multi;           // for both maxn and paranoid
+    uint64_t seed;
+} SimConfig;
+
+typedef struct {
+    const SimConfig *config;
+    long long games;
+    uint64_t rng;
+    long long wins[MAX_PLAYERS];
+    long long draws;
+    long long moves;
+    long long lengths[MAX_CELLS + 1];
+    long long playouts;
+    double mctsSeconds;
+} SimWorker;
+
+static const char *kindNames[] = {"random", "search", "mcts", "maxn", "paranoid"};
+
+static double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int parseKind(const char *name, PlayerKind *kind) {
+    for (int k = 0; k < (int)(sizeof kindNames / sizeof kindNames[0]); k++)
+        if (strcmp(name, kindNames[k]) == 0) {
+            *kind = (PlayerKind)k;
+            return 1;
+        }
+    return 0;
+}
+
+// "random,search" or "random,random,random"; the count sets the players
+static int parsePlayers(char *list, SimConfig *config) {
+    int n = 0;
+    for (char *name = strtok(list, ","); name; name = strtok(NULL, ",")) {
+        if (n == MAX_PLAYERS || !parseKind(name, &config->kinds[n])) return 0;
+        n++;
+    }
+    if (n < 2) return 0;
+    config->players = n;
+    return 1;
+}
+
+// Play one game and return the winner, or -1 for a draw. multi holds a
+// max^n and a paranoid search.
+static int playGame(SimWorker *w, Search *search, Mcts *mcts, MultiSearch *multi, Board *b, int *length) {
+    const SimConfig *config = w->config;
+    int player = 0, ply = 0;
+    boardInit(b, config->size);
+    while (1) {
+        int move;
+        if (config->kinds[player] == PLAYER_SEARCH && ply >= config->randomPlies) {
+            move = searchBestMove(search, b, player, 1 - player, NULL);
+        } else if (config->kinds[player] == PLAYER_MCTS && ply >= config->randomPlies) {
+            MctsResult r;
+            move = mctsBestMove(mcts, b, player, config->players, &r);
+            w->playouts += r.playouts;
+            w->mctsSeconds += r.seconds;
+        } else if (config->kinds[player] == PLAYER_MAXN && ply >= config->randomPlies) {
+            move = multiBestMove(&multi[0], b, player, config->players, NULL);
+        } else if (config->kinds[player] == PLAYER_PARANOID && ply >= config->randomPlies) {
+            move = multiBestMove(&multi[1], b, player, config->players, NULL);
+        } else
+            move = b->freeCells[rngBelow(&w->rng, b->freeCount)];
+        boardPlace(b, move, player);
+        ply++;
+        if (boardWinsAt(b, move, player)) {
+            *length = ply;
+            return player;
+        }
+        if (boardIsDrawn(b)) {
+            *length = ply;
+            return -1;
+        }
+        player = (player + 1) % config->players;
+    }
+}
+
+static void *workerMain(void *arg) {
+    SimWorker *w = arg;
+    Search search;
+    Mcts mcts;
+    MultiSearch multi[2];
+    MultiConfig multiConfig = w->config->multi;
+    Board b;
+    int needSearch = 0, needMcts = 0, needMulti[2] = {0, 0};
+
+    for (int p = 0; p < w->config->players; p++) {
+        needSearch |= w->config->kinds[p] == PLAYER_SEARCH;
+        needMcts |= w->config->kinds[p] == PLAYER_MCTS;
+        needMulti[0] |= w->config->kinds[p] == PLAYER_MAXN;
+        needMulti[1] |= w->config->kinds[p] == PLAYER_PARANOID;
+    }
+    for (int i = 0; i < 2; i++) {
+        multiConfig.mode = i ? MULTI_PARANOID : MULTI_MAXN;
+        if (needMulti[i] && !multiInit(&multi[i], &multiConfig)) {
+            fprintf(stderr, "Couldn't allocate a search table.\n");
+            return NULL;
+        }
+    }
+    if (needSearch && !searchInit(&search, &w->config->search)) {
+        fprintf(stderr, "Couldn't allocate a search table.\n");
+        return NULL;
+    }
+    if (needMcts && !mctsInit(&mcts, &w->config->mcts)) {
+        fprintf(stderr, "Couldn't allocate an MCTS node pool.\n");
+        if (needSearch) searchFree(&search);
+        return NULL;
+    }
+
+    for (long long g = 0; g < w->games; g++) {
+        int length, winner = playGame(w, &search, &mcts, multi, &b, &length);
+        if (winner < 0) w->draws++;
+        else w->wins[winner]++;
+        w->moves += length;
+        w->lengths[length]++;
+    }
+
+    if (needSearch) searchFree(&search);
+    if (needMcts) mctsFree(&mcts);
+    for (int i = 0; i < 2; i++)
+        if (needMulti[i]) multiFree(&multi[i]);
+    return NULL;
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr,
+            "usage: %s [-n games] [-s size] [-p kinds] [-j threads]\n"
+            "          [-r random plies] [-d depth] [-t ms] [-m table MB]\n"
+            "          [-i mcts playouts] [-S seed]\n"
+            "  kinds is a comma list of 2 or 3 of: random, search, mcts, maxn, paranoid\n",
+            prog);
+}
+
+int main(int argc, char *argv[]) {
+    SimConfig config = {3, 2, {PLAYER_RANDOM, PLAYER_RANDOM, PLAYER_RANDOM},
+                        100000, 0, 0, {0, 4 << 20, 0, 1}, {1000, 0, 1, 1 << 17, 0},
+                        {MULTI_MAXN, 0, 4 << 20, 0}, 0};
+    SimWorker *workers;
+    pthread_t *threads;
+    long long totalWins[MAX_PLAYERS] = {0}, totalDraws = 0, totalMoves = 0;
+    long long lengths[MAX_CELLS + 1] = {0}, playouts = 0;
+    double start, elapsed, mctsSeconds = 0;
+    int opt;
+
+    config.seed = (uint64_t)time(NULL);
+    while ((opt = getopt(argc, argv, "n:s:p:j:r:d:t:m:i:S:")) != -1) {
+        switch (opt) {
+        case 'n': config.games = atoll(optarg); break;
+        case 's': config.size = atoi(optarg); break;
+        case 'p':
+            if (!parsePlayers(optarg, &config)) {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'j': config.threads = atoi(optarg); break;
+        case 'r': config.randomPlies = atoi(optarg); break;
+        case 'd': config.search.maxDepth = config.multi.maxDepth = atoi(optarg); break;
+        case 't':
+            config.search.timeMs = config.multi.timeMs = atoi(optarg);
+            config.mcts.timeMs = atoi(optarg);
+            config.mcts.iterations = 0;
+            break;
+        case 'm':
+            config.search.ttBytes = config.multi.ttBytes = (size_t)atoi(optarg) << 20;
+            config.mcts.maxNodes = config.search.ttBytes / (2 * sizeof(MctsNode));
+            break;
+        case 'i': config.mcts.iterations = atoi(optarg); break;
+        case 'S': config.seed = strtoull(optarg, NULL, 10); break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (config.size < MIN_SIZE || config.size > MAX_SIZE || config.games < 1) {
+        usage(argv[0]);
+        return 1;
+    }
+    for (int p = 0; p < config.players; p++)
+        if (config.kinds[p] == PLAYER_SEARCH && config.players != 2) {
+            fprintf(stderr, "The search player only handles two-player games.\n");
+            return 1;
+        }
+    if (config.threads < 1)
+        config.threads = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    if (config.threads > config.games)
+        config.threads = (int)config.games;
+
+    workers = calloc(config.threads, sizeof *workers);
+    threads = calloc(config.threads, sizeof *threads);
+    if (!workers || !threads) {
+        fprintf(stderr, "Out of memory.\n");
+        return 1;
+    }
+
+    start = nowSeconds();
+    for (int i = 0; i < config.threads; i++) {
+        workers[i].config = &config;
+        workers[i].games = config.games / config.threads + (i < config.games % config.threads);
+        workers[i].rng = config.seed + (uint64_t)i * 0x632BE59BD9B4E019ULL;
+        if (pthread_create(&threads[i], NULL, workerMain, &workers[i]) != 0) {
+            fprintf(stderr, "Couldn't start thread %d.\n", i);
+            return 1;
+        }
+    }
+    for (int i = 0; i < config.threads; i++) {
+        pthread_join(threads[i], NULL);
+        for (int p = 0; p < MAX_PLAYERS; p++)
+            totalWins[p] += workers[i].wins[p];
+        totalDraws += workers[i].draws;
+        totalMoves += workers[i].moves;
+        for (int n = 0; n <= MAX_CELLS; n++)
+            lengths[n] += workers[i].lengths[n];
+        playouts += workers[i].playouts;
+        mctsSeconds += workers[i].mctsSeconds;
+    }
+    elapsed = nowSeconds() - start;
+
+    printf("%lld games on %dx%d, %d players, %d threads\n",
+           config.games, config.size, config.size, config.players, config.threads);
+    printf("%.3f s, %.0f games/s, %.0f moves/s\n",
+           elapsed, config.games / elapsed, totalMoves / elapsed);
+    for (int p = 0; p < config.players; p++)
+        printf("%c (%s) wins: %lld (%.2f%%)\n", playerSymbols[p], kindNames[config.kinds[p]],
+               totalWins[p], 100.0 * totalWins[p] / config.games);
+    if (playouts)
+        printf("MCTS: %lld playouts, %.0f playouts/s per thread\n",
+               playouts, playouts / mctsSeconds);
+    printf("Draws: %lld (%.2f%%)\n", totalDraws, 100.0 * totalDraws / config.games);
+    printf("Average length: %.2f moves\n", (double)totalMoves / config.games);
+    printf("Length histogram:");
+    for (int n = 0; n <= MAX_CELLS; n++)
+        if (lengths[n]) printf(" %d:%lld", n, lengths[n]);
+    printf("\n");
+
+    free(workers);
+    free(threads);
+    return 0;
+}
@@ -0,0 +1,185 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "perfect.h"
+
+// Offline solver for the perfect-play tables in perfect.h: every position
+// reachable on a two-player 3x3 or 4x4 board is searched to the end and
+// each canonical one gets its best move. The 3x3 table is written as C
+// source to compile in, the 4x4 one as a file to map at run time:
+//
+//   gcc -O2 -o solve solve.c perfect.c board.c
+//   ./solve 3 -c > perfect3.c
+//   ./solve 4 perfect4.tbl
+//
+// Scores are from the mover's side: 100 minus the plies to a win, minus
+// that for a loss, 0 for a draw.
+
+#define UNKNOWN (-128)
+
+static int size, cells, lineCount;
+static uint32_t full;
+static uint32_t lines[MAX_LINES];
+static uint32_t cellLines[PERFECT_MAX_CELLS][MAX_CELL_LINES];   // lines through each cell
+static int cellLineCount[PERFECT_MAX_CELLS];
+static uint32_t pow3[PERFECT_MAX_CELLS + 1];
+static signed char *memo;          // score of every position by raw key
+
+// board.c's winning segments, as plain row-major cell masks
+static void makeLines(void) {
+    Board b;
+    const LineTable *t;
+    boardInit(&b, size);
+    t = boardLines(&b);
+    lineCount = t->count;
+    for (int i = 0; i < lineCount; i++) {
+        lines[i] = 0;
+        for (int cell = 0; cell < cells; cell++)
+            if (t->lines[i] & cellMask(&b, cell)) lines[i] |= 1u << cell;
+    }
+    for (int cell = 0; cell < cells; cell++) {
+        cellLineCount[cell] = t->cellCount[cell];
+        for (int i = 0; i < t->cellCount[cell]; i++)
+            cellLines[cell][i] = lines[t->cellLines[cell][i]];
+    }
+}
+
+static int winsAt(uint32_t mask, int cell) {
+    for (int i = 0; i < cellLineCount[cell]; i++)
+        if ((mask & cellLines[cell][i]) == cellLines[cell][i]) return 1;
+    return 0;
+}
+
+static uint32_t rawKey(uint32_t mover, uint32_t opponent) {
+    uint32_t key = 0;
+    for (int cell = 0; cell < cells; cell++)
+        key += pow3[cell] * ((mover >> cell & 1) + 2 * (opponent >> cell & 1));
+    return key;
+}
+
+static void decodeKey(uint32_t key, uint32_t *mover, uint32_t *opponent) {
+    *mover = *opponent = 0;
+    for (int cell = 0; cell < cells; cell++, key /= 3) {
+        if (key % 3 == 1) *mover |= 1u << cell;
+        if (key % 3 == 2) *opponent |= 1u << cell;
+    }
+}
+
+static int solve(uint32_t mover, uint32_t opponent);
+
+// Score of playing cell, for the mover
+static int moveScore(uint32_t mover, uint32_t opponent, int cell) {
+    int score;
+    mover |= 1u << cell;
+    if (winsAt(mover, cell)) return 99;
+    if ((mover | opponent) == full) return 0;
+    score = -solve(opponent, mover);
+    return score > 0 ? score - 1 : score < 0 ? score + 1 : 0;
+}
+
+static int solve(uint32_t mover, uint32_t opponent) {
+    uint32_t key = rawKey(mover, opponent);
+    int best = -100;
+    if (memo[key] != UNKNOWN) return memo[key];
+    for (uint32_t empty = full & ~(mover | opponent); empty; empty &= empty - 1) {
+        int score = moveScore(mover, opponent, __builtin_ctz(empty));
+        if (score > best) best = score;
+    }
+    memo[key] = (signed char)best;
+    return best;
+}
+
+// Reached, unfinished and the smallest of its symmetries
+static int isStored(uint32_t key) {
+    uint32_t mover, opponent;
+    if (memo[key] == UNKNOWN) return 0;
+    decodeKey(key, &mover, &opponent);
+    return perfectKey(size, mover, opponent, NULL) == key;
+}
+
+int main(int argc, char *argv[]) {
+    uint32_t keyCount, count = 0, slots;
+    uint32_t *keys;
+    uint8_t *entries;
+    int asSource, value;
+
+    if (argc != 3 || (atoi(argv[1]) != 3 && atoi(argv[1]) != 4)) {
+        fprintf(stderr, "usage: %s 3|4 (-c | table file)\n", argv[0]);
+        return 1;
+    }
+    size = atoi(argv[1]);
+    asSource = strcmp(argv[2], "-c") == 0;
+    cells = size * size;
+    full = (1u << cells) - 1;
+    pow3[0] = 1;
+    for (int i = 1; i <= cells; i++) pow3[i] = pow3[i - 1] * 3;
+    keyCount = pow3[cells];
+    makeLines();
+    memo = malloc(keyCount);
+    if (!memo) {
+        fprintf(stderr, "Out of memory.\n");
+        return 1;
+    }
+    memset(memo, UNKNOWN, keyCount);
+    value = solve(0, 0);
+    fprintf(stderr, "%dx%d, %d in a row: %s for the first player\n", size, size,
+            boardWinLength(size), value > 0 ? "win" : value < 0 ? "loss" : "draw");
+
+    for (uint32_t key = 0; key < keyCount; key++)
+        if (isStored(key)) count++;
+    for (slots = 1; slots < count + count / 2; slots *= 2) {}
+    keys = malloc((size_t)slots * sizeof *keys);
+    entries = calloc(slots, 1);
+    if (!keys || !entries) {
+        fprintf(stderr, "Out of memory.\n");
+        return 1;
+    }
+    memset(keys, 0xFF, (size_t)slots * sizeof *keys);
+
+    for (uint32_t key = 0; key < keyCount; key++) {
+        uint32_t mover, opponent, slot;
+        int best = -101, move = 0, score = memo[key];
+        if (!isStored(key)) continue;
+        decodeKey(key, &mover, &opponent);
+        for (uint32_t empty = full & ~(mover | opponent); empty; empty &= empty - 1) {
+            int cell = __builtin_ctz(empty), s = moveScore(mover, opponent, cell);
+            if (s > best) {
+                best = s;
+                move = cell;
+            }
+        }
+        for (slot = perfectSlot(key, slots); keys[slot] != PERFECT_EMPTY; slot = (slot + 1) & (slots - 1)) {}
+        keys[slot] = key;
+        entries[slot] = (uint8_t)(move | (score > 0 ? PERFECT_WIN : score < 0 ? PERFECT_LOSS : PERFECT_DRAW) << 4);
+    }
+    fprintf(stderr, "%u canonical positions in %u slots\n", count, slots);
+
+    if (asSource) {
+        printf("// Generated by solve.c (./solve 3 -c > perfect3.c), do not edit\n");
+        printf("#include \"perfect.h\"\n\n");
+        printf("static const uint32_t keys[%u] = {", slots);
+        for (uint32_t i = 0; i < slots; i++)
+            if (keys[i] == PERFECT_EMPTY) printf("%s%sPERFECT_EMPTY", i ? "," : "", i % 8 ? " " : "\n    ");
+            else printf("%s%s%u", i ? "," : "", i % 8 ? " " : "\n    ", keys[i]);
+        printf("\n};\n\nstatic const uint8_t entries[%u] = {", slots);
+        for (uint32_t i = 0; i < slots; i++)
+            printf("%s%s0x%02x", i ? "," : "", i % 12 ? " " : "\n    ", entries[i]);
+        printf("\n};\n\nconst PerfectTable perfect3 = {3, %u, keys, entries, NULL, 0};\n", slots);
+    } else {
+        unsigned char header[PERFECT_HEADER] = {'T', 'T', 'T', 'P', PERFECT_VERSION};
+        FILE *out = fopen(argv[2], "wb");
+        header[5] = (unsigned char)size;
+        header[6] = (unsigned char)boardWinLength(size);
+        memcpy(header + 8, &slots, sizeof slots);
+        if (!out || fwrite(header, 1, sizeof header, out) != sizeof header ||
+            fwrite(keys, sizeof *keys, slots, out) != slots ||
+            fwrite(entries, 1, slots, out) != slots || fclose(out) != 0) {
+            perror(argv[2]);
+            return 1;
+        }
+    }
+    free(memo);
+    free(keys);
+    free(entries);
+    return 0;
+}
@@ -0,0 +1,79 @@
+#include <stdlib.h>
+#include <string.h>
+#include "tt.h"
+
+static uint64_t pack(int score, int depth, int bound, int move) {
+    return (uint64_t)(uint16_t)(int16_t)score
+         | (uint64_t)(uint8_t)depth << 16
+         | (uint64_t)(uint8_t)bound << 24
+         | (uint64_t)(uint8_t)(move + 1) << 32
+         | 1ULL << 40;   // never zero, so an empty slot is data == 0
+}
+
+static void unpack(uint64_t data, TTHit *hit) {
+    hit->score = (int16_t)(data & 0xFFFF);
+    hit->depth = (int)((data >> 16) & 0xFF);
+    hit->bound = (int)((data >> 24) & 0xFF);
+    hit->move = (int)((data >> 32) & 0xFF) - 1;
+}
+
+static void readEntry(const TTEntry *e, uint64_t *key, uint64_t *data) {
+    *data = __atomic_load_n(&e->data, __ATOMIC_RELAXED);
+    *key = __atomic_load_n(&e->key, __ATOMIC_RELAXED) ^ *data;
+}
+
+static void writeEntry(TTEntry *e, uint64_t key, uint64_t data) {
+    __atomic_store_n(&e->key, key ^ data, __ATOMIC_RELAXED);
+    __atomic_store_n(&e->data, data, __ATOMIC_RELAXED);
+}
+
+// Size the table to the largest power of two buckets within the budget.
+// Returns 0 if the memory couldn't be allocated.
+int ttInit(TransTable *tt, size_t bytes) {
+    size_t buckets = 1;
+    while (buckets * 2 * 2 * sizeof(TTEntry) <= bytes)
+        buckets *= 2;
+    tt->entries = calloc(buckets * 2, sizeof(TTEntry));
+    tt->buckets = tt->entries ? buckets : 0;
+    return tt->entries != NULL;
+}
+
+void ttFree(TransTable *tt) {
+    free(tt->entries);
+    tt->entries = NULL;
+    tt->buckets = 0;
+}
+
+void ttClear(TransTable *tt) {
+    memset(tt->entries, 0, tt->buckets * 2 * sizeof(TTEntry));
+}
+
+int ttProbe(const TransTable *tt, uint64_t key, TTHit *hit) {
+    const TTEntry *bucket = &tt->entries[(key & (tt->buckets - 1)) * 2];
+    for (int i = 0; i < 2; i++) {
+        uint64_t k, data;
+        readEntry(&bucket[i], &k, &data);
+        if (k == key && data) {
+            unpack(data, hit);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+void ttStore(TransTable *tt, uint64_t key, int score, int depth, int bound, int move) {
+    TTEntry *bucket = &tt->entries[(key & (tt->buckets - 1)) * 2];
+    uint64_t oldKey, oldData;
+    TTHit old;
+    readEntry(&bucket[0], &oldKey, &oldData);
+    unpack(oldData, &old);
+    if (oldKey == key || oldData == 0 || depth >= old.depth) {
+        // The result it displaces from the deep slot still gets a turn
+        // in the always-replace slot
+        if (oldKey != key && oldData != 0)
+            writeEntry(&bucket[1], oldKey, oldData);
+        writeEntry(&bucket[0], key, pack(score, depth, bound, move));
+    } else {
+        writeEntry(&bucket[1], key, pack(score, depth, bound, move));
+    }
+}
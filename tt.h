@@ -0,0 +1,39 @@
+#ifndef TT_H
+#define TT_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Bound stored with a score
+#define TT_EXACT 0
+#define TT_LOWER 1   // score >= stored (fail high)
+#define TT_UPPER 2   // score <= stored (fail low)
+
+// The key is stored XORed with the data, so a torn write from another
+// search thread just reads back as a miss and the table needs no locks.
+typedef struct {
+    uint64_t key;    // position key ^ data
+    uint64_t data;   // packed score, depth, bound and move
+} TTEntry;
+
+// Two entries per bucket: slot 0 keeps the deepest result seen for the
+// bucket, slot 1 always takes the newest one.
+typedef struct {
+    TTEntry *entries;
+    size_t buckets;          // power of two
+} TransTable;
+
+typedef struct {
+    int score;
+    int depth;
+    int bound;
+    int move;
+} TTHit;
+
+int  ttInit(TransTable *tt, size_t bytes);
+void ttFree(TransTable *tt);
+void ttClear(TransTable *tt);
+int  ttProbe(const TransTable *tt, uint64_t key, TTHit *hit);
+void ttStore(TransTable *tt, uint64_t key, int score, int depth, int bound, int move);
+
+#endif